@@ -0,0 +1,49 @@
+#version 330
+
+uniform sampler2D textureSampler;
+uniform sampler2D weightSampler;
+uniform int interpolationFunction;
+uniform float textureWidth;
+uniform float textureHeight;
+
+// (1, 0) for the horizontal pass, (0, 1) for the vertical pass
+uniform vec2 direction;
+
+in vec2 textureCoordinate;
+
+out vec4 color;
+
+// weights are precomputed for the argument range -2.0f - 2.0f, one row per interpolation function
+float weight(float x)
+{
+	vec2 weightSize = vec2(textureSize(weightSampler, 0));
+	float u = ((x + 2.0f) / 4.0f) * ((weightSize.x - 1.0f) / weightSize.x) + 0.5f / weightSize.x;
+	float v = (float(interpolationFunction) + 0.5f) / weightSize.y;
+	
+	return texture(weightSampler, vec2(u, v)).r;
+}
+
+void main()
+{
+	float size = dot(vec2(textureWidth, textureHeight), direction);
+	float position = dot(textureCoordinate, direction) * size - 0.5f;
+	float base = floor(position);
+	float alpha = position - base;
+	
+	vec4 num = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	float den = 0.0f;
+	
+	for(int i = -1; i <= 2; i++)
+	{
+		// sample exactly at the texel centers along the pass direction (this avoids hardware bilinear)
+		float coordinate = (base + float(i) + 0.5f) / size;
+		vec2 sampleCoordinate = mix(textureCoordinate, vec2(coordinate, coordinate), direction);
+		
+		float f = weight(float(i) - alpha); // argument range is -2.0f - 2.0f
+		
+		num += texture(textureSampler, sampleCoordinate) * f;
+		den += f;
+	}
+	
+	color = num / den;
+}
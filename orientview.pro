@@ -64,34 +64,50 @@ RCC_DIR = build
 UI_DIR = build
 
 HEADERS  += \
+    src/BatchEncoder.h \
+    src/ByteReader.h \
+    src/CpuCompositor.h \
     src/EncodeWindow.h \
     src/FrameData.h \
+    src/FramePacer.h \
     src/GpxReader.h \
     src/InputHandler.h \
     src/MainWindow.h \
     src/MapImageReader.h \
     src/MovingAverage.h \
     src/Mp4File.h \
+    src/PipelineQueue.h \
+    src/PipelineStage.h \
     src/QuickRouteReader.h \
     src/Renderer.h \
     src/RenderOffScreenThread.h \
     src/RenderOnScreenThread.h \
+    src/RouteCache.h \
+    src/RouteIndex.h \
     src/RouteManager.h \
     src/RoutePoint.h \
+    src/RouteTrack.h \
+    src/SegmentFile.h \
     src/Settings.h \
     src/SimpleLogger.h \
     src/SplitsManager.h \
     src/StabilizeWindow.h \
+    src/ThreadPool.h \
     src/VideoDecoder.h \
     src/VideoDecoderThread.h \
     src/VideoEncoder.h \
     src/VideoEncoderThread.h \
     src/VideoStabilizer.h \
     src/VideoStabilizerThread.h \
-    src/VideoWindow.h
+    src/VideoWindow.h \
+    src/VideoWriterThread.h
 
 SOURCES += \
+    src/BatchEncoder.cpp \
+    src/ByteReader.cpp \
+    src/CpuCompositor.cpp \
     src/EncodeWindow.cpp \
+    src/FramePacer.cpp \
     src/GpxReader.cpp \
     src/InputHandler.cpp \
     src/Main.cpp \
@@ -99,22 +115,29 @@ SOURCES += \
     src/MapImageReader.cpp \
     src/MovingAverage.cpp \
     src/Mp4File.cpp \
+    src/PipelineQueue.cpp \
+    src/PipelineStage.cpp \
     src/QuickRouteReader.cpp \
     src/Renderer.cpp \
     src/RenderOffScreenThread.cpp \
     src/RenderOnScreenThread.cpp \
+    src/RouteCache.cpp \
+    src/RouteIndex.cpp \
     src/RouteManager.cpp \
+    src/SegmentFile.cpp \
     src/Settings.cpp \
     src/SimpleLogger.cpp \
     src/SplitsManager.cpp \
     src/StabilizeWindow.cpp \
+    src/ThreadPool.cpp \
     src/VideoDecoder.cpp \
     src/VideoDecoderThread.cpp \
     src/VideoEncoder.cpp \
     src/VideoEncoderThread.cpp \
     src/VideoStabilizer.cpp \
     src/VideoStabilizerThread.cpp \
-    src/VideoWindow.cpp
+    src/VideoWindow.cpp \
+    src/VideoWriterThread.cpp
 
 FORMS    += \
     src/EncodeWindow.ui \
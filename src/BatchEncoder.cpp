@@ -0,0 +1,483 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <algorithm>
+
+#include <QFile>
+#include <QSettings>
+#include <QTime>
+
+#include "BatchEncoder.h"
+#include "Settings.h"
+#include "VideoDecoder.h"
+#include "VideoEncoder.h"
+#include "QuickRouteReader.h"
+#include "MapImageReader.h"
+#include "VideoStabilizer.h"
+#include "InputHandler.h"
+#include "SplitsManager.h"
+#include "RouteManager.h"
+#include "Renderer.h"
+#include "VideoDecoderThread.h"
+#include "RenderOffScreenThread.h"
+#include "VideoEncoderThread.h"
+#include "PipelineQueue.h"
+
+using namespace OrientView;
+
+namespace
+{
+	// longer than any split transition or runner position averaging window
+	const double routePreRollTime = 10.0;
+
+	void addQueueStatistics(PipelineQueueStatistics& total, const PipelineQueueStatistics& current, size_t pipelineCount)
+	{
+		total.capacity = current.capacity;
+		total.averageOccupancy += current.averageOccupancy / pipelineCount;
+		total.producerWaitTime += current.producerWaitTime;
+		total.consumerWaitTime += current.consumerWaitTime;
+	}
+}
+
+bool BatchEncoder::initialize(const QString& settingsFilePath, const QString& outputFilePath)
+{
+	qDebug("Initializing batch encoder (%s)", qPrintable(settingsFilePath));
+
+	if (!QFile::exists(settingsFilePath))
+	{
+		qWarning("Could not find the settings file");
+		return false;
+	}
+
+	settings = new Settings();
+
+	QSettings iniFileSettings(settingsFilePath, QSettings::IniFormat);
+	settings->readFromQSettings(&iniFileSettings);
+
+	if (!outputFilePath.isEmpty())
+		settings->encoder.outputVideoFilePath = outputFilePath;
+
+	// there is nobody to ask whether to continue, so every failure is fatal
+	videoDecoder = new VideoDecoder();
+
+	if (!videoDecoder->initialize(settings))
+		return false;
+
+	mapImageReader = new MapImageReader();
+
+	if (!mapImageReader->initialize(settings))
+		return false;
+
+	quickRouteReader = new QuickRouteReader();
+
+	if (!quickRouteReader->initialize(mapImageReader, settings))
+		return false;
+
+	std::vector<double> segmentTimes = getSegmentTimes();
+	size_t segmentCount = segmentTimes.size() - 1;
+
+	if (segmentCount > 1 && settings->stabilizer.enabled && settings->stabilizer.mode == VideoStabilizerMode::RealTime)
+		qWarning("Real-time stabilization restarts at every segment, consider using preprocessed stabilization data");
+
+	for (size_t i = 0; i < segmentCount; ++i)
+	{
+		BatchPipeline* pipeline = new BatchPipeline();
+		pipelines.push_back(pipeline);
+
+		QString segmentFilePath = (segmentCount > 1) ? QString("%1.segment%2.tmp").arg(settings->encoder.outputVideoFilePath, QString::number(i)) : QString();
+
+		if (!initializePipeline(pipeline, segmentTimes.at(i), segmentTimes.at(i + 1), segmentFilePath))
+			return false;
+	}
+
+	totalFrameCount = videoDecoder->getTotalFrameCount();
+
+	return true;
+}
+
+BatchEncoder::~BatchEncoder()
+{
+	for (BatchPipeline* pipeline : pipelines)
+		deletePipeline(pipeline);
+
+	pipelines.clear();
+
+	if (quickRouteReader != nullptr)
+	{
+		delete quickRouteReader;
+		quickRouteReader = nullptr;
+	}
+
+	if (mapImageReader != nullptr)
+	{
+		delete mapImageReader;
+		mapImageReader = nullptr;
+	}
+
+	if (videoDecoder != nullptr)
+	{
+		delete videoDecoder;
+		videoDecoder = nullptr;
+	}
+
+	if (settings != nullptr)
+	{
+		delete settings;
+		settings = nullptr;
+	}
+}
+
+// Blocks until the whole video has been encoded. Returns the process exit code.
+int BatchEncoder::run()
+{
+	qDebug("Encoding %s using %d segment(s)", qPrintable(settings->encoder.outputVideoFilePath), (int)pipelines.size());
+
+	for (BatchPipeline* pipeline : pipelines)
+	{
+		if (pipeline->context != nullptr)
+		{
+			pipeline->context->doneCurrent();
+			pipeline->context->moveToThread(pipeline->renderOffScreenThread);
+		}
+	}
+
+	elapsedTimer.start();
+
+	for (BatchPipeline* pipeline : pipelines)
+	{
+		pipeline->videoDecoderThread->start();
+		pipeline->renderOffScreenThread->start();
+		pipeline->videoEncoderThread->start();
+	}
+
+	for (BatchPipeline* pipeline : pipelines)
+	{
+		while (!pipeline->videoEncoderThread->wait(1000))
+		{
+			statisticsMutex.lock();
+			BatchStatistics currentStatistics = statistics;
+			statisticsMutex.unlock();
+
+			printProgress(currentStatistics, false);
+		}
+
+		if (pipeline->videoEncoderThread->getHasFailed())
+		{
+			qWarning("Encoding failed");
+			return 1;
+		}
+	}
+
+	if (pipelines.size() > 1 && !muxSegments())
+		return 1;
+
+	printProgress(statistics, true);
+	printQueueStatistics();
+
+	if (statistics.frameCount == 0)
+	{
+		qWarning("No frames were encoded");
+		return 1;
+	}
+
+	return 0;
+}
+
+// Returns the segment boundaries, the segments after the first one start at keyframes so that they can be decoded independently.
+std::vector<double> BatchEncoder::getSegmentTimes()
+{
+	double startTime = settings->video.startTimeOffset;
+	double endTime = videoDecoder->getTotalDuration();
+
+	std::vector<double> segmentTimes;
+	segmentTimes.push_back(startTime);
+
+	if (settings->encoder.segmentCount > 1)
+	{
+		std::vector<double> keyframeTimes = videoDecoder->getKeyframeTimes();
+
+		if (keyframeTimes.empty())
+			qWarning("Could not find any keyframes, encoding as a single segment");
+
+		for (int i = 1; i < settings->encoder.segmentCount && !keyframeTimes.empty(); ++i)
+		{
+			double targetTime = startTime + i * (endTime - startTime) / settings->encoder.segmentCount;
+			auto keyframeTime = std::lower_bound(keyframeTimes.begin(), keyframeTimes.end(), targetTime);
+
+			// sparse keyframes can snap several boundaries to the same keyframe
+			if (keyframeTime != keyframeTimes.end() && *keyframeTime > segmentTimes.back() && *keyframeTime < endTime)
+				segmentTimes.push_back(*keyframeTime);
+		}
+	}
+
+	segmentTimes.push_back(endTime);
+
+	return segmentTimes;
+}
+
+bool BatchEncoder::initializePipeline(BatchPipeline* pipeline, double startTime, double endTime, const QString& segmentFilePath)
+{
+	bool isSegment = !segmentFilePath.isEmpty();
+
+	pipeline->segmentFilePath = segmentFilePath;
+	pipeline->videoDecoder = new VideoDecoder();
+
+	if (!pipeline->videoDecoder->initialize(settings))
+		return false;
+
+	if (isSegment)
+	{
+		qDebug("Initializing segment %.2f - %.2f s", startTime, endTime);
+		pipeline->videoDecoder->setSegment(startTime, endTime);
+	}
+
+	if (!settings->encoder.useCpuRenderer)
+	{
+		QSurfaceFormat surfaceFormat;
+		surfaceFormat.setSamples(settings->window.multisamples);
+
+		pipeline->surface = new QOffscreenSurface();
+		pipeline->surface->setFormat(surfaceFormat);
+		pipeline->surface->create();
+
+		if (!pipeline->surface->isValid())
+		{
+			qWarning("Could not create offscreen surface");
+			return false;
+		}
+
+		pipeline->context = new QOpenGLContext();
+		pipeline->context->setFormat(surfaceFormat);
+
+		if (!pipeline->context->create())
+		{
+			qWarning("Could not create OpenGL context");
+			return false;
+		}
+
+		if (!pipeline->context->makeCurrent(pipeline->surface))
+		{
+			qWarning("Could not make context current");
+			return false;
+		}
+	}
+
+	pipeline->videoEncoder = new VideoEncoder();
+	pipeline->renderer = new Renderer();
+	pipeline->videoStabilizer = new VideoStabilizer();
+	pipeline->inputHandler = new InputHandler();
+	pipeline->splitsManager = new SplitsManager();
+	pipeline->routeManager = new RouteManager();
+	pipeline->videoDecoderThread = new VideoDecoderThread();
+	pipeline->renderOffScreenThread = new RenderOffScreenThread();
+	pipeline->videoEncoderThread = new VideoEncoderThread();
+
+	if (!pipeline->videoEncoder->initialize(pipeline->videoDecoder, settings, segmentFilePath))
+		return false;
+
+	if (!pipeline->renderer->initialize(pipeline->videoDecoder, mapImageReader, pipeline->videoStabilizer, pipeline->inputHandler, pipeline->routeManager, settings, true))
+		return false;
+
+	if (!pipeline->videoStabilizer->initialize(settings, false))
+		return false;
+
+	pipeline->splitsManager->initialize(settings);
+
+	if (!pipeline->routeManager->initialize(quickRouteReader, pipeline->splitsManager, pipeline->renderer, settings))
+		return false;
+
+	// run the route smoothing up to the segment start, so that the view continues seamlessly from the previous segment
+	if (isSegment)
+	{
+		double frameDuration = pipeline->videoDecoder->getFrameDuration();
+
+		for (double time = std::max(0.0, startTime - routePreRollTime); time < startTime && frameDuration > 0.0; time += frameDuration / 1000.0)
+			pipeline->routeManager->update(time, frameDuration);
+	}
+
+	pipeline->videoDecoderThread->initialize(pipeline->videoDecoder, settings->encoder.queueLength, true);
+	pipeline->renderOffScreenThread->initialize(pipeline->context, pipeline->surface, pipeline->videoDecoder, pipeline->videoDecoderThread, pipeline->videoStabilizer, pipeline->routeManager, pipeline->renderer, pipeline->videoEncoder, settings->encoder.queueLength);
+	pipeline->videoEncoderThread->initialize(pipeline->videoEncoder, pipeline->renderOffScreenThread);
+
+	// called on the encoder thread, there is no event loop to queue the signal to
+	QObject::connect(pipeline->videoEncoderThread, &VideoEncoderThread::frameProcessed, [this](int frameNumber, int frameSize, double currentTime, double decodeDuration, double stabilizeDuration, double renderDuration, double encodeDuration)
+	{
+		Q_UNUSED(frameNumber);
+		Q_UNUSED(currentTime);
+		frameProcessed(frameSize, decodeDuration, stabilizeDuration, renderDuration, encodeDuration);
+	});
+
+	return true;
+}
+
+void BatchEncoder::deletePipeline(BatchPipeline* pipeline)
+{
+	if (pipeline->videoEncoderThread != nullptr)
+	{
+		pipeline->videoEncoderThread->stop();
+		pipeline->videoEncoderThread->wait();
+		delete pipeline->videoEncoderThread;
+		pipeline->videoEncoderThread = nullptr;
+	}
+
+	if (pipeline->renderOffScreenThread != nullptr)
+	{
+		pipeline->renderOffScreenThread->stop();
+		pipeline->renderOffScreenThread->wait();
+		delete pipeline->renderOffScreenThread;
+		pipeline->renderOffScreenThread = nullptr;
+	}
+
+	if (pipeline->videoDecoderThread != nullptr)
+	{
+		pipeline->videoDecoderThread->stop();
+		pipeline->videoDecoderThread->wait();
+		delete pipeline->videoDecoderThread;
+		pipeline->videoDecoderThread = nullptr;
+	}
+
+	if (pipeline->context != nullptr)
+		pipeline->context->makeCurrent(pipeline->surface);
+
+	if (pipeline->routeManager != nullptr)
+	{
+		delete pipeline->routeManager;
+		pipeline->routeManager = nullptr;
+	}
+
+	if (pipeline->splitsManager != nullptr)
+	{
+		delete pipeline->splitsManager;
+		pipeline->splitsManager = nullptr;
+	}
+
+	if (pipeline->inputHandler != nullptr)
+	{
+		delete pipeline->inputHandler;
+		pipeline->inputHandler = nullptr;
+	}
+
+	if (pipeline->videoStabilizer != nullptr)
+	{
+		delete pipeline->videoStabilizer;
+		pipeline->videoStabilizer = nullptr;
+	}
+
+	if (pipeline->renderer != nullptr)
+	{
+		delete pipeline->renderer;
+		pipeline->renderer = nullptr;
+	}
+
+	if (pipeline->videoEncoder != nullptr)
+	{
+		delete pipeline->videoEncoder;
+		pipeline->videoEncoder = nullptr;
+	}
+
+	if (pipeline->context != nullptr)
+	{
+		pipeline->context->doneCurrent();
+		delete pipeline->context;
+		pipeline->context = nullptr;
+	}
+
+	if (pipeline->surface != nullptr)
+	{
+		pipeline->surface->destroy();
+		delete pipeline->surface;
+		pipeline->surface = nullptr;
+	}
+
+	if (pipeline->videoDecoder != nullptr)
+	{
+		delete pipeline->videoDecoder;
+		pipeline->videoDecoder = nullptr;
+	}
+
+	if (!pipeline->segmentFilePath.isEmpty())
+		QFile::remove(pipeline->segmentFilePath);
+
+	delete pipeline;
+}
+
+// Copies the encoded segments in order to the output file.
+bool BatchEncoder::muxSegments()
+{
+	qDebug("Muxing %d segments to %s", (int)pipelines.size(), qPrintable(settings->encoder.outputVideoFilePath));
+
+	VideoEncoder muxer;
+
+	if (!muxer.initialize(videoDecoder, settings))
+		return false;
+
+	for (BatchPipeline* pipeline : pipelines)
+	{
+		if (!muxer.appendSegment(pipeline->segmentFilePath))
+			return false;
+	}
+
+	return muxer.close();
+}
+
+// Called on the encoder thread of a pipeline. The durations were measured by each stage for this frame and passed along with it.
+void BatchEncoder::frameProcessed(int frameSize, double decodeDuration, double stabilizeDuration, double renderDuration, double encodeDuration)
+{
+	QMutexLocker locker(&statisticsMutex);
+
+	statistics.frameCount++;
+	statistics.totalFrameSize += frameSize;
+	statistics.decodeDuration += decodeDuration;
+	statistics.stabilizeDuration += stabilizeDuration;
+	statistics.renderDuration += renderDuration;
+	statistics.encodeDuration += encodeDuration;
+}
+
+void BatchEncoder::printProgress(const BatchStatistics& currentStatistics, bool isFinished)
+{
+	if (currentStatistics.frameCount == 0)
+	{
+		qDebug("Waiting for the first frame");
+		return;
+	}
+
+	double elapsedTime = elapsedTimer.elapsed() / 1000.0;
+	double framesPerSecond = currentStatistics.frameCount / elapsedTime;
+	double frameCount = currentStatistics.frameCount;
+
+	QString timingsText = QString("decode %1 ms, stabilize %2 ms, render %3 ms, encode %4 ms").arg(
+		QString::number(currentStatistics.decodeDuration / frameCount, 'f', 2),
+		QString::number(currentStatistics.stabilizeDuration / frameCount, 'f', 2),
+		QString::number(currentStatistics.renderDuration / frameCount, 'f', 2),
+		QString::number(currentStatistics.encodeDuration / frameCount, 'f', 2));
+
+	if (isFinished)
+	{
+		qDebug("Encoded %d frames in %s (%.2f fps, %.2f MB)", currentStatistics.frameCount, qPrintable(QTime(0, 0, 0, 0).addMSecs((int)(elapsedTime * 1000.0)).toString()), framesPerSecond, currentStatistics.totalFrameSize / 1000000.0);
+		qDebug("Average frame timings: %s", qPrintable(timingsText));
+
+		return;
+	}
+
+	// the segments are encoded in parallel, so the progress is counted in encoded frames
+	double progress = (totalFrameCount > 0) ? (double)currentStatistics.frameCount / totalFrameCount : 0.0;
+	int remainingTimeMs = (totalFrameCount > 0) ? (int)((totalFrameCount - currentStatistics.frameCount) / framesPerSecond * 1000.0) : 0;
+
+	qDebug("Frame %d/%d (%.1f %%), %.2f fps, %s remaining - %s", currentStatistics.frameCount, (int)totalFrameCount, progress * 100.0, framesPerSecond, qPrintable(QTime(0, 0, 0, 0).addMSecs(std::max(0, remainingTimeMs)).toString()), qPrintable(timingsText));
+}
+
+// The waiting side of a queue is faster than the other side, and a queue that stays full points to a bottleneck after it.
+void BatchEncoder::printQueueStatistics()
+{
+	PipelineQueueStatistics decodedStatistics;
+	PipelineQueueStatistics renderedStatistics;
+
+	for (BatchPipeline* pipeline : pipelines)
+	{
+		addQueueStatistics(decodedStatistics, pipeline->videoDecoderThread->getOutputQueue()->getStatistics(), pipelines.size());
+		addQueueStatistics(renderedStatistics, pipeline->renderOffScreenThread->getOutputQueue()->getStatistics(), pipelines.size());
+	}
+
+	qDebug("Decoded frame queue: average occupancy %.2f/%d, decoder waited %.0f ms, renderer waited %.0f ms", decodedStatistics.averageOccupancy, decodedStatistics.capacity, decodedStatistics.producerWaitTime, decodedStatistics.consumerWaitTime);
+	qDebug("Rendered frame queue: average occupancy %.2f/%d, renderer waited %.0f ms, encoder waited %.0f ms", renderedStatistics.averageOccupancy, renderedStatistics.capacity, renderedStatistics.producerWaitTime, renderedStatistics.consumerWaitTime);
+}
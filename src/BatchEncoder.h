@@ -0,0 +1,96 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+
+namespace OrientView
+{
+	class Settings;
+	class VideoDecoder;
+	class VideoEncoder;
+	class QuickRouteReader;
+	class MapImageReader;
+	class VideoStabilizer;
+	class InputHandler;
+	class SplitsManager;
+	class RouteManager;
+	class Renderer;
+	class VideoDecoderThread;
+	class RenderOffScreenThread;
+	class VideoEncoderThread;
+
+	// Summed stage durations of the encoded frames, updated from the encoder threads.
+	struct BatchStatistics
+	{
+		int frameCount = 0;
+		int64_t totalFrameSize = 0;
+		double decodeDuration = 0.0;
+		double stabilizeDuration = 0.0;
+		double renderDuration = 0.0;
+		double encodeDuration = 0.0;
+	};
+
+	// One independent decode-render-encode pipeline, encoding either the whole video or one segment of it.
+	struct BatchPipeline
+	{
+		VideoDecoder* videoDecoder = nullptr;
+		VideoEncoder* videoEncoder = nullptr;
+		VideoStabilizer* videoStabilizer = nullptr;
+		InputHandler* inputHandler = nullptr;
+		SplitsManager* splitsManager = nullptr;
+		RouteManager* routeManager = nullptr;
+		Renderer* renderer = nullptr;
+		VideoDecoderThread* videoDecoderThread = nullptr;
+		RenderOffScreenThread* renderOffScreenThread = nullptr;
+		VideoEncoderThread* videoEncoderThread = nullptr;
+
+		QOffscreenSurface* surface = nullptr;
+		QOpenGLContext* context = nullptr;
+
+		QString segmentFilePath;
+	};
+
+	// Runs the encoding pipeline from the command line without creating any windows.
+	class BatchEncoder
+	{
+
+	public:
+
+		bool initialize(const QString& settingsFilePath, const QString& outputFilePath);
+		~BatchEncoder();
+
+		int run();
+
+	private:
+
+		std::vector<double> getSegmentTimes();
+		bool initializePipeline(BatchPipeline* pipeline, double startTime, double endTime, const QString& segmentFilePath);
+		void deletePipeline(BatchPipeline* pipeline);
+		bool muxSegments();
+
+		void frameProcessed(int frameSize, double decodeDuration, double stabilizeDuration, double renderDuration, double encodeDuration);
+		void printProgress(const BatchStatistics& currentStatistics, bool isFinished);
+		void printQueueStatistics();
+
+		Settings* settings = nullptr;
+		VideoDecoder* videoDecoder = nullptr;
+		QuickRouteReader* quickRouteReader = nullptr;
+		MapImageReader* mapImageReader = nullptr;
+
+		std::vector<BatchPipeline*> pipelines;
+
+		int64_t totalFrameCount = 0;
+		QElapsedTimer elapsedTimer;
+		QMutex statisticsMutex;
+		BatchStatistics statistics;
+	};
+}
@@ -0,0 +1,104 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <cstring>
+
+#include "ByteReader.h"
+
+using namespace OrientView;
+
+ByteReader::ByteReader(const uint8_t* data, size_t size) : data(data), size(size)
+{
+}
+
+uint8_t ByteReader::readUInt8()
+{
+	if (!canRead(1))
+		return 0;
+
+	return data[position++];
+}
+
+uint16_t ByteReader::readUInt16()
+{
+	if (!canRead(2))
+		return 0;
+
+	uint16_t value = (uint16_t)(data[position] | (data[position + 1] << 8));
+	position += 2;
+
+	return value;
+}
+
+uint32_t ByteReader::readUInt32()
+{
+	if (!canRead(4))
+		return 0;
+
+	uint32_t value = 0;
+
+	for (int i = 3; i >= 0; --i)
+		value = (value << 8) | data[position + i];
+
+	position += 4;
+
+	return value;
+}
+
+uint64_t ByteReader::readUInt64()
+{
+	if (!canRead(8))
+		return 0;
+
+	uint64_t value = 0;
+
+	for (int i = 7; i >= 0; --i)
+		value = (value << 8) | data[position + i];
+
+	position += 8;
+
+	return value;
+}
+
+double ByteReader::readDouble()
+{
+	uint64_t bits = readUInt64();
+	double value;
+	memcpy(&value, &bits, sizeof(double));
+
+	return value;
+}
+
+void ByteReader::skip(size_t count)
+{
+	if (canRead(count))
+		position += count;
+}
+
+size_t ByteReader::getPosition() const
+{
+	return position;
+}
+
+bool ByteReader::atEnd() const
+{
+	return position >= size;
+}
+
+bool ByteReader::hasError() const
+{
+	return error;
+}
+
+// A failed read moves to the end, so that loops reading until the end stop.
+bool ByteReader::canRead(size_t count)
+{
+	if (count > size - position)
+	{
+		position = size;
+		error = true;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,39 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace OrientView
+{
+	// Read little-endian values from memory owned by someone else. Reading past the end gives zeros and sets the error flag.
+	class ByteReader
+	{
+
+	public:
+
+		ByteReader(const uint8_t* data, size_t size);
+
+		uint8_t readUInt8();
+		uint16_t readUInt16();
+		uint32_t readUInt32();
+		uint64_t readUInt64();
+		double readDouble();
+		void skip(size_t count);
+
+		size_t getPosition() const;
+		bool atEnd() const;
+		bool hasError() const;
+
+	private:
+
+		bool canRead(size_t count);
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		size_t position = 0;
+		bool error = false;
+	};
+}
@@ -0,0 +1,222 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ORIENTVIEW_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "CpuCompositor.h"
+
+using namespace OrientView;
+
+namespace
+{
+	// bilinear interpolation of four RGBA pixels, the fractions are in 1/256 units
+	inline uint32_t interpolate(uint32_t topLeft, uint32_t topRight, uint32_t bottomLeft, uint32_t bottomRight, uint32_t fractionX, uint32_t fractionY)
+	{
+#ifdef ORIENTVIEW_USE_SSE2
+		__m128i zero = _mm_setzero_si128();
+
+		// all four channels of the left and right pixel side by side as 16-bit values
+		__m128i top = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)topRight, (int)topLeft), zero);
+		__m128i bottom = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)bottomRight, (int)bottomLeft), zero);
+
+		// the weighted sums stay below 65536, so the low half of the products is enough
+		__m128i vertical = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16((short)(256 - fractionY))), _mm_mullo_epi16(bottom, _mm_set1_epi16((short)fractionY)));
+		vertical = _mm_srli_epi16(vertical, 8);
+
+		__m128i horizontal = _mm_add_epi16(_mm_mullo_epi16(vertical, _mm_set1_epi16((short)(256 - fractionX))), _mm_mullo_epi16(_mm_srli_si128(vertical, 8), _mm_set1_epi16((short)fractionX)));
+		horizontal = _mm_srli_epi16(horizontal, 8);
+
+		return (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(horizontal, zero));
+#else
+		uint32_t result = 0;
+
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			uint32_t left = ((((topLeft >> shift) & 0xff) * (256 - fractionY)) + (((bottomLeft >> shift) & 0xff) * fractionY)) >> 8;
+			uint32_t right = ((((topRight >> shift) & 0xff) * (256 - fractionY)) + (((bottomRight >> shift) & 0xff) * fractionY)) >> 8;
+
+			result |= (((left * (256 - fractionX)) + (right * fractionX)) >> 8) << shift;
+		}
+
+		return result;
+#endif
+	}
+
+	// the RGBA pixels are handled as 32-bit words, so the alpha byte position depends on the byte order
+	uint32_t getAlphaMask()
+	{
+		uint8_t bytes[4] = { 0, 0, 0, 255 };
+		uint32_t mask;
+		memcpy(&mask, bytes, 4);
+
+		return mask;
+	}
+
+	uint32_t getPixel(const QColor& color)
+	{
+		uint8_t bytes[4] = { (uint8_t)color.red(), (uint8_t)color.green(), (uint8_t)color.blue(), 255 };
+		uint32_t pixel;
+		memcpy(&pixel, bytes, 4);
+
+		return pixel;
+	}
+
+	// Samples the source image for each frame pixel in the given rows. Source coordinates are stepped in 16.16 fixed point.
+	void drawRows(const QImage& image, const QRect& sourceRect, const QTransform& inverseTransform, uint8_t* frameBits, int frameRowLength, const QRect& targetRect, int firstRow, int lastRow)
+	{
+		const uint8_t* imageBits = image.constBits();
+		int imageRowLength = image.bytesPerLine();
+		int maxX = image.width() - 1;
+		int maxY = image.height() - 1;
+
+		// pixel centers are at half coordinates, the bounds are shifted so that the sample position is the top left texel
+		int32_t minU = (sourceRect.left() << 16) - 32768;
+		int32_t maxU = ((sourceRect.right() + 1) << 16) - 32768;
+		int32_t minV = (sourceRect.top() << 16) - 32768;
+		int32_t maxV = ((sourceRect.bottom() + 1) << 16) - 32768;
+		int32_t stepU = (int32_t)(inverseTransform.m11() * 65536.0);
+		int32_t stepV = (int32_t)(inverseTransform.m12() * 65536.0);
+
+		uint32_t alphaMask = getAlphaMask();
+
+		for (int y = firstRow; y <= lastRow; ++y)
+		{
+			uint32_t* destination = (uint32_t*)(frameBits + y * frameRowLength);
+			QPointF start = inverseTransform.map(QPointF(targetRect.left() + 0.5, y + 0.5));
+			int32_t u = (int32_t)std::floor((start.x() - 0.5) * 65536.0);
+			int32_t v = (int32_t)std::floor((start.y() - 0.5) * 65536.0);
+
+			for (int x = targetRect.left(); x <= targetRect.right(); ++x, u += stepU, v += stepV)
+			{
+				if (u < minU || u >= maxU || v < minV || v >= maxV)
+					continue;
+
+				int x0 = std::max(0, std::min(u >> 16, maxX));
+				int x1 = std::max(0, std::min((u >> 16) + 1, maxX));
+				int y0 = std::max(0, std::min(v >> 16, maxY));
+				int y1 = std::max(0, std::min((v >> 16) + 1, maxY));
+
+				const uint32_t* row0 = (const uint32_t*)(imageBits + y0 * imageRowLength);
+				const uint32_t* row1 = (const uint32_t*)(imageBits + y1 * imageRowLength);
+
+				destination[x] = interpolate(row0[x0], row0[x1], row1[x0], row1[x1], (uint32_t)(u >> 8) & 0xff, (uint32_t)(v >> 8) & 0xff) | alphaMask;
+			}
+		}
+	}
+}
+
+bool CpuCompositor::initialize(uint8_t* frameData, int width, int height, int rowLength)
+{
+	qDebug("Initializing CPU compositor");
+
+	// the frame is painted to directly, QPainter is used for the vector graphics
+	frameImage = QImage(frameData, width, height, rowLength, QImage::Format_RGBA8888_Premultiplied);
+
+	if (frameImage.isNull())
+	{
+		qWarning("Could not create frame image");
+		return false;
+	}
+
+	// the thread that finishes the drawing works too
+	if (threadPool.getThreadCount() == 1)
+		threadPool.initialize(std::max(1, (int)std::thread::hardware_concurrency()) - 1);
+
+	drawCommands.clear();
+
+	return true;
+}
+
+void CpuCompositor::fill(const QRect& rect, const QColor& color)
+{
+	// the images drawn before have to stay under the fill
+	finishDrawing();
+
+	QRect targetRect = rect & frameImage.rect();
+
+	if (targetRect.isEmpty())
+		return;
+
+	uint8_t* frameBits = frameImage.bits();
+	int frameRowLength = frameImage.bytesPerLine();
+	uint32_t pixel = getPixel(color);
+
+	for (int y = targetRect.top(); y <= targetRect.bottom(); ++y)
+	{
+		uint32_t* destination = (uint32_t*)(frameBits + y * frameRowLength);
+		std::fill(destination + targetRect.left(), destination + targetRect.right() + 1, pixel);
+	}
+}
+
+// The image has to be in a 32-bit RGBA format and stay unchanged until finishDrawing(). The transform maps the source image pixel coordinates to the frame pixel coordinates.
+void CpuCompositor::drawImage(const QImage& image, const QRect& sourceRect, const QTransform& transform, const QRect& clipRect)
+{
+	QRect targetRect = transform.mapRect(QRectF(sourceRect)).toAlignedRect() & clipRect & frameImage.rect();
+
+	if (targetRect.isEmpty())
+		return;
+
+	bool isInvertible = false;
+	QTransform inverseTransform = transform.inverted(&isInvertible);
+
+	if (!isInvertible)
+		return;
+
+	DrawCommand command;
+	command.image = &image;
+	command.sourceRect = sourceRect;
+	command.inverseTransform = inverseTransform;
+	command.targetRect = targetRect;
+
+	drawCommands.push_back(command);
+}
+
+// Draws all the queued images with one run of the thread pool. The frame rows are split into bands and each band draws the images in the order they were queued.
+void CpuCompositor::finishDrawing()
+{
+	if (drawCommands.empty())
+		return;
+
+	QRect boundingRect;
+
+	for (const DrawCommand& command : drawCommands)
+		boundingRect |= command.targetRect;
+
+	uint8_t* frameBits = frameImage.bits();
+	int frameRowLength = frameImage.bytesPerLine();
+
+	// more bands than threads evens out the load when the images cover the rows unevenly
+	int bandCount = std::min(threadPool.getThreadCount() * 4, boundingRect.height());
+	int bandHeight = (boundingRect.height() + bandCount - 1) / bandCount;
+	bandCount = (boundingRect.height() + bandHeight - 1) / bandHeight;
+
+	threadPool.run(bandCount, [&](int bandIndex)
+	{
+		int bandFirstRow = boundingRect.top() + bandIndex * bandHeight;
+		int bandLastRow = std::min(bandFirstRow + bandHeight - 1, boundingRect.bottom());
+
+		for (const DrawCommand& command : drawCommands)
+		{
+			int firstRow = std::max(bandFirstRow, command.targetRect.top());
+			int lastRow = std::min(bandLastRow, command.targetRect.bottom());
+
+			if (firstRow <= lastRow)
+				drawRows(*command.image, command.sourceRect, command.inverseTransform, frameBits, frameRowLength, command.targetRect, firstRow, lastRow);
+		}
+	});
+
+	drawCommands.clear();
+}
+
+QImage& CpuCompositor::getFrameImage()
+{
+	return frameImage;
+}
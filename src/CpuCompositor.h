@@ -0,0 +1,47 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QImage>
+#include <QTransform>
+#include <QRect>
+#include <QColor>
+
+#include "ThreadPool.h"
+
+namespace OrientView
+{
+	// Composites the rendered frames in software, used for encoding without an OpenGL context.
+	// The images are drawn in batches by a pool of threads, each thread drawing all the images for its own band of rows.
+	class CpuCompositor
+	{
+
+	public:
+
+		bool initialize(uint8_t* frameData, int width, int height, int rowLength);
+
+		void fill(const QRect& rect, const QColor& color);
+		void drawImage(const QImage& image, const QRect& sourceRect, const QTransform& transform, const QRect& clipRect);
+		void finishDrawing();
+
+		QImage& getFrameImage();
+
+	private:
+
+		struct DrawCommand
+		{
+			const QImage* image = nullptr;
+			QRect sourceRect;
+			QTransform inverseTransform;
+			QRect targetRect;
+		};
+
+		QImage frameImage;
+		ThreadPool threadPool;
+		std::vector<DrawCommand> drawCommands;
+	};
+}
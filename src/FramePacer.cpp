@@ -0,0 +1,164 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <QString>
+
+#include "FramePacer.h"
+#include "Settings.h"
+
+using namespace OrientView;
+
+void FramePacer::initialize(Settings* settings, double refreshRate)
+{
+	// with vsync the swap blocks until the next vertical blank, so start it half a refresh period early to hit the closest one
+	if (settings->window.enableVsync && refreshRate > 0.0)
+		presentationOffset = (int64_t)(500000.0 / refreshRate);
+	else
+		presentationOffset = 0;
+
+	averageDrift.setAlpha(0.01);
+
+	reset();
+}
+
+// Next frame will be scheduled from the current time instead of the video clock.
+void FramePacer::reset()
+{
+	isSynchronized = false;
+}
+
+// Sleeps until the deadline of the next frame, returns the time left before the sleep in milliseconds.
+double FramePacer::waitForPresentation(int64_t frameDuration)
+{
+	int64_t currentTime = getTime();
+	int64_t nextDeadline = currentDeadline + frameDuration;
+
+	// the video clock is followed as long as we are not too late, otherwise it's better to start over
+	if (!isSynchronized || (currentTime - nextDeadline) > resynchronizationThreshold)
+	{
+		if (isSynchronized)
+			resynchronizationCount++;
+
+		nextDeadline = currentTime + presentationOffset;
+		isSynchronized = true;
+	}
+
+	currentDeadline = nextDeadline;
+	currentFrameDuration = frameDuration;
+
+	int64_t wakeUpTime = currentDeadline - presentationOffset;
+	int64_t spareTime = wakeUpTime - currentTime;
+
+	if (spareTime > 0)
+		sleepUntil(wakeUpTime);
+
+	return spareTime / 1000.0;
+}
+
+void FramePacer::framePresented()
+{
+	if (!isSynchronized)
+		return;
+
+	int64_t lateness = getTime() - currentDeadline;
+	int64_t jitter = std::abs(lateness);
+
+	averageDrift.addMeasurement(lateness / 1000.0);
+
+	int jitterBin = std::min((int)(jitter / jitterBinWidth), (int)jitterHistogram.size() - 1);
+	jitterHistogram[jitterBin]++;
+
+	if (currentFrameDuration > 0 && lateness >= currentFrameDuration)
+	{
+		int missBin = std::min((int)(lateness / currentFrameDuration), (int)missHistogram.size() - 1);
+		missHistogram[missBin]++;
+	}
+
+	presentedFrameCount++;
+}
+
+double FramePacer::getAverageDrift() const
+{
+	return averageDrift.getAverage();
+}
+
+// Frames that were presented at least one frame duration late.
+int FramePacer::getMissedFrameCount() const
+{
+	int count = 0;
+
+	for (int i = 1; i < (int)missHistogram.size(); ++i)
+		count += missHistogram[i];
+
+	return count;
+}
+
+int FramePacer::getResynchronizationCount() const
+{
+	return resynchronizationCount;
+}
+
+void FramePacer::logStatistics() const
+{
+	if (presentedFrameCount == 0)
+		return;
+
+	int maxCount = *std::max_element(jitterHistogram.begin(), jitterHistogram.end());
+
+	qDebug("Frame pacing: %d frames, average drift %.3f ms, %d resynchronizations", presentedFrameCount, averageDrift.getAverage(), resynchronizationCount);
+	qDebug("Frame jitter:");
+
+	for (int i = 0; i < (int)jitterHistogram.size(); ++i)
+	{
+		QString range = (i < (int)jitterHistogram.size() - 1) ? QString("%1 - %2 ms").arg(i * jitterBinWidth / 1000.0, 4, 'f', 1).arg((i + 1) * jitterBinWidth / 1000.0, 4, 'f', 1) : QString(">= %1 ms").arg(i * jitterBinWidth / 1000.0, 4, 'f', 1);
+		QString bar = QString(maxCount > 0 ? (jitterHistogram[i] * 50) / maxCount : 0, '#');
+
+		qDebug("%15s %8d %s", qPrintable(range), jitterHistogram[i], qPrintable(bar));
+	}
+
+	qDebug("Frame misses:");
+
+	for (int i = 1; i < (int)missHistogram.size(); ++i)
+	{
+		QString range = (i < (int)missHistogram.size() - 1) ? QString("%1 frames late").arg(i) : QString(">= %1 frames late").arg(i);
+		qDebug("%18s %8d", qPrintable(range), missHistogram[i]);
+	}
+}
+
+// Microseconds from the monotonic clock.
+int64_t FramePacer::getTime() const
+{
+#ifdef __linux__
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void FramePacer::sleepUntil(int64_t deadline)
+{
+#ifdef __linux__
+	timespec ts;
+	ts.tv_sec = deadline / 1000000;
+	ts.tv_nsec = (deadline % 1000000) * 1000;
+
+	// an absolute deadline does not accumulate error when the sleep is interrupted and restarted
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+	std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::microseconds(deadline)));
+#endif
+}
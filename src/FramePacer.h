@@ -0,0 +1,51 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MovingAverage.h"
+
+namespace OrientView
+{
+	class Settings;
+
+	// Schedule frame presentation against the video clock using absolute deadlines.
+	class FramePacer
+	{
+
+	public:
+
+		void initialize(Settings* settings, double refreshRate);
+		void reset();
+
+		double waitForPresentation(int64_t frameDuration);
+		void framePresented();
+
+		double getAverageDrift() const;
+		int getMissedFrameCount() const;
+		int getResynchronizationCount() const;
+		void logStatistics() const;
+
+	private:
+
+		int64_t getTime() const;
+		void sleepUntil(int64_t deadline);
+
+		bool isSynchronized = false;
+		int64_t currentDeadline = 0;
+		int64_t currentFrameDuration = 0;
+		int64_t presentationOffset = 0;
+		int64_t resynchronizationThreshold = 100000;
+
+		MovingAverage averageDrift;
+
+		const int jitterBinWidth = 500;
+		std::vector<int> jitterHistogram = std::vector<int>(21, 0);
+		std::vector<int> missHistogram = std::vector<int>(5, 0);
+		int presentedFrameCount = 0;
+		int resynchronizationCount = 0;
+	};
+}
@@ -1,84 +1,276 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include <QDebug>
-#include <QFile>
-#include <QXmlStreamReader>
-
-#include "GpxReader.h"
-
-using namespace OrientView;
-
-bool GpxReader::initialize(const QString& fileName)
-{
-	qDebug("Initializing GpxReader (%s)", qPrintable(fileName));
-
-	QFile file(fileName);
-
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-	{
-		qWarning("Could not open GPX file");
-		return false;
-	}
-
-	QXmlStreamReader xmlStream(&file);
-	trackPoints.clear();
-
-	TrackPoint trackPoint;
-
-	while (!xmlStream.atEnd() && !xmlStream.hasError())
-	{
-		xmlStream.readNext();
-
-		if (xmlStream.isStartElement())
-		{
-			if (xmlStream.name() == "trkpt")
-			{
-				trackPoint = TrackPoint();
-
-				trackPoint.latitude = xmlStream.attributes().value("lat").toDouble();
-				trackPoint.longitude = xmlStream.attributes().value("lon").toDouble();
-
-				continue;
-			}
-
-			if (xmlStream.name() == "time")
-			{
-				xmlStream.readNext();
-				trackPoint.dateTime = QDateTime::fromString(xmlStream.text().toString(), Qt::ISODate);
-
-				continue;
-			}
-
-			if (xmlStream.name() == "ele")
-			{
-				xmlStream.readNext();
-				trackPoint.elevation = xmlStream.text().toString().toDouble();
-
-				continue;
-			}
-
-			if (xmlStream.name() == "hr")
-			{
-				xmlStream.readNext();
-				trackPoint.heartRate = xmlStream.text().toString().toDouble();
-			}
-		}
-
-		if (xmlStream.isEndElement())
-		{
-			if (xmlStream.name() == "trkpt")
-				trackPoints.push_back(trackPoint);
-		}
-	}
-
-	if (xmlStream.hasError())
-		qWarning("There was an error while parsing GPX: %s", qPrintable(xmlStream.errorString()));
-
-	return true;
-}
-
-const std::vector<TrackPoint>& GpxReader::getTrackPoints() const
-{
-	return trackPoints;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QByteArray>
+#include <QXmlStreamReader>
+
+#include "GpxReader.h"
+
+using namespace OrientView;
+
+namespace
+{
+	// Garmin writes a TCX Lap for every lap split, also the automatic ones, so only a pause this long between laps is a recording gap
+	const int64_t lapGapMilliseconds = 60000;
+
+	bool readDigits(const QChar* text, int length, int& index, int digitCount, int& value)
+	{
+		value = 0;
+
+		for (int i = 0; i < digitCount; ++i, ++index)
+		{
+			if (index >= length || !text[index].isDigit())
+				return false;
+
+			value = value * 10 + text[index].digitValue();
+		}
+
+		return true;
+	}
+
+	bool readCharacter(const QChar* text, int length, int& index, char character)
+	{
+		if (index >= length || text[index] != QLatin1Char(character))
+			return false;
+
+		index++;
+		return true;
+	}
+
+	// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+	int64_t daysFromCivil(int64_t year, int month, int day)
+	{
+		year -= (month <= 2) ? 1 : 0;
+		int64_t era = (year >= 0 ? year : year - 399) / 400;
+		int64_t yearOfEra = year - era * 400;
+		int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+		int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+		return era * 146097 + dayOfEra - 719468;
+	}
+
+	// Parses the ISO 8601 timestamps of GPX and TCX files (e.g. 2014-06-01T12:34:56.789+03:00) without any allocations.
+	// A missing time zone is taken as UTC.
+	bool parseDateTime(const QStringRef& textRef, QDateTime& dateTime)
+	{
+		QStringRef trimmed = textRef.trimmed();
+		const QChar* text = trimmed.unicode();
+		int length = trimmed.size();
+		int index = 0;
+
+		int year, month, day, hour, minute, second;
+
+		if (!readDigits(text, length, index, 4, year) || !readCharacter(text, length, index, '-') ||
+			!readDigits(text, length, index, 2, month) || !readCharacter(text, length, index, '-') ||
+			!readDigits(text, length, index, 2, day) || !readCharacter(text, length, index, 'T') ||
+			!readDigits(text, length, index, 2, hour) || !readCharacter(text, length, index, ':') ||
+			!readDigits(text, length, index, 2, minute) || !readCharacter(text, length, index, ':') ||
+			!readDigits(text, length, index, 2, second))
+		{
+			return false;
+		}
+
+		if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+			return false;
+
+		int milliseconds = 0;
+
+		// fractional seconds, only the first three digits matter
+		if (index < length && text[index] == QLatin1Char('.'))
+		{
+			index++;
+			int scale = 100;
+
+			while (index < length && text[index].isDigit())
+			{
+				milliseconds += text[index].digitValue() * scale;
+				scale /= 10;
+				index++;
+			}
+		}
+
+		int zoneOffsetMinutes = 0;
+
+		if (index < length && text[index] == QLatin1Char('Z'))
+			index++;
+		else if (index < length && (text[index] == QLatin1Char('+') || text[index] == QLatin1Char('-')))
+		{
+			int sign = (text[index] == QLatin1Char('-')) ? -1 : 1;
+			int zoneHours, zoneMinutes;
+			index++;
+
+			if (!readDigits(text, length, index, 2, zoneHours))
+				return false;
+
+			readCharacter(text, length, index, ':');
+
+			if (!readDigits(text, length, index, 2, zoneMinutes))
+				return false;
+
+			zoneOffsetMinutes = sign * (zoneHours * 60 + zoneMinutes);
+		}
+
+		if (index != length)
+			return false;
+
+		int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - zoneOffsetMinutes * 60;
+		dateTime = QDateTime::fromMSecsSinceEpoch(seconds * 1000 + milliseconds, Qt::UTC);
+
+		return true;
+	}
+}
+
+// GPX track points are trkpt elements with lat and lon attributes. TCX track points are Trackpoint elements with a Position child.
+// The data is parsed as a stream, and the values are converted straight from the parser's string references.
+bool GpxReader::read(const uint8_t* data, size_t size)
+{
+	qDebug("Reading GPS track");
+
+	// the data is not copied
+	QByteArray buffer = QByteArray::fromRawData((const char*)data, (int)size);
+	QXmlStreamReader xmlStream(buffer);
+
+	trackPoints.clear();
+
+	TrackPoint trackPoint;
+	bool isInTrackPoint = false;
+	bool isInHeartRate = false;
+	bool hasPosition = false;
+	int segmentIndex = -1;
+	int lapTrackCount = 0;
+	bool isLapStart = false;
+
+	while (!xmlStream.atEnd() && !xmlStream.hasError())
+	{
+		xmlStream.readNext();
+
+		if (xmlStream.isStartElement())
+		{
+			QStringRef name = xmlStream.name();
+
+			// each GPX recording segment starts after a gap
+			if (name == QLatin1String("trkseg"))
+			{
+				segmentIndex++;
+				continue;
+			}
+
+			if (name == QLatin1String("Lap"))
+			{
+				lapTrackCount = 0;
+				isLapStart = true;
+
+				continue;
+			}
+
+			// a TCX lap continues the recording, but a second track in the same lap means that the recording was stopped in between
+			if (name == QLatin1String("Track"))
+			{
+				segmentIndex = (lapTrackCount > 0) ? segmentIndex + 1 : std::max(0, segmentIndex);
+				lapTrackCount++;
+
+				continue;
+			}
+
+			if (name == QLatin1String("trkpt"))
+			{
+				trackPoint = TrackPoint();
+				isInTrackPoint = true;
+
+				trackPoint.latitude = xmlStream.attributes().value(QLatin1String("lat")).toDouble(&hasPosition);
+				trackPoint.longitude = xmlStream.attributes().value(QLatin1String("lon")).toDouble();
+
+				continue;
+			}
+
+			if (name == QLatin1String("Trackpoint"))
+			{
+				trackPoint = TrackPoint();
+				isInTrackPoint = true;
+				hasPosition = false;
+
+				continue;
+			}
+
+			if (!isInTrackPoint)
+				continue;
+
+			if (name == QLatin1String("HeartRateBpm"))
+			{
+				isInHeartRate = true;
+				continue;
+			}
+
+			bool isTime = (name == QLatin1String("time") || name == QLatin1String("Time"));
+			bool isLatitude = (name == QLatin1String("LatitudeDegrees"));
+			double* value = nullptr;
+
+			if (name == QLatin1String("ele") || name == QLatin1String("AltitudeMeters"))
+				value = &trackPoint.elevation;
+			else if (name == QLatin1String("hr") || (isInHeartRate && name == QLatin1String("Value")))
+				value = &trackPoint.heartRate;
+			else if (isLatitude)
+				value = &trackPoint.latitude;
+			else if (name == QLatin1String("LongitudeDegrees"))
+				value = &trackPoint.longitude;
+
+			// only the known value elements are read further, the text is valid until the next read
+			if (!isTime && value == nullptr)
+				continue;
+
+			xmlStream.readNext();
+
+			if (!xmlStream.isCharacters())
+				continue;
+
+			if (isTime)
+				parseDateTime(xmlStream.text(), trackPoint.dateTime);
+			else if (isLatitude)
+				*value = xmlStream.text().toDouble(&hasPosition);
+			else
+				*value = xmlStream.text().toDouble();
+
+			continue;
+		}
+
+		if (xmlStream.isEndElement())
+		{
+			QStringRef name = xmlStream.name();
+
+			if (name == QLatin1String("HeartRateBpm"))
+				isInHeartRate = false;
+
+			// points without a position or a time cannot be placed on the route
+			if (name == QLatin1String("trkpt") || name == QLatin1String("Trackpoint"))
+			{
+				if (hasPosition && trackPoint.dateTime.isValid())
+				{
+					if (isLapStart && !trackPoints.empty() && trackPoints.back().dateTime.msecsTo(trackPoint.dateTime) >= lapGapMilliseconds)
+						segmentIndex++;
+
+					isLapStart = false;
+					trackPoint.segmentIndex = std::max(0, segmentIndex);
+					trackPoints.push_back(trackPoint);
+				}
+
+				isInTrackPoint = false;
+			}
+		}
+	}
+
+	if (xmlStream.hasError())
+	{
+		qWarning("There was an error while parsing GPS track: %s", qPrintable(xmlStream.errorString()));
+		return false;
+	}
+
+	return true;
+}
+
+const std::vector<TrackPoint>& GpxReader::getTrackPoints() const
+{
+	return trackPoints;
+}
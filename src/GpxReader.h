@@ -1,34 +1,39 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QString>
-#include <QDateTime>
-
-namespace OrientView
-{
-	struct TrackPoint
-	{
-		QDateTime dateTime;
-
-		double latitude = 0.0;
-		double longitude = 0.0;
-		double elevation = 0.0;
-		double heartRate = 0.0;
-	};
-
-	// Read track point data from GPX files.
-	class GpxReader
-	{
-
-	public:
-
-		bool initialize(const QString& fileName);
-		const std::vector<TrackPoint>& getTrackPoints() const;
-
-	private:
-
-		std::vector<TrackPoint> trackPoints;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+#include <QDateTime>
+
+namespace OrientView
+{
+	struct TrackPoint
+	{
+		QDateTime dateTime;
+
+		double latitude = 0.0;
+		double longitude = 0.0;
+		double elevation = 0.0;
+		double heartRate = 0.0;
+
+		int segmentIndex = 0;
+	};
+
+	// Read track point data from GPX and TCX files.
+	class GpxReader
+	{
+
+	public:
+
+		bool read(const uint8_t* data, size_t size);
+		const std::vector<TrackPoint>& getTrackPoints() const;
+
+	private:
+
+		std::vector<TrackPoint> trackPoints;
+	};
+}
@@ -1,65 +1,117 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include <typeinfo>
-
-#include <QApplication>
-#include <QDir>
-#include <QFontDatabase>
-
-#include "MainWindow.h"
-#include "SimpleLogger.h"
-
-namespace
-{
-	OrientView::SimpleLogger logger;
-
-	void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
-	{
-		logger.handleMessage(type, context, message);
-	}
-}
-
-int main(int argc, char *argv[])
-{
-	try
-	{
-		QCoreApplication::setOrganizationDomain("orientview.com");
-		
-#ifdef Q_OS_WIN32
-		QCoreApplication::setOrganizationName("OrientView");
-		QCoreApplication::setApplicationName("OrientView");
-		QCoreApplication::addLibraryPath("data/plugins");
-#else
-		QCoreApplication::setOrganizationName("orientview");
-		QCoreApplication::setApplicationName("orientview");
-#endif
-		
-		QApplication app(argc, argv);
-
-		QDir::setCurrent(QCoreApplication::applicationDirPath());
-
-		logger.initialize("orientview.log");
-		qInstallMessageHandler(messageHandler);
-
-		QFontDatabase::addApplicationFont("data/fonts/dejavu-sans-bold.ttf");
-
-		OrientView::MainWindow mainWindow;
-
-		logger.setMainWindow(&mainWindow);
-
-		if (argc >= 2 && QFile::exists(QString(argv[1])))
-			mainWindow.readSettingsFromIniFile(QString(argv[1]));
-		else
-			mainWindow.readSettingsFromLocal();
-
-		mainWindow.show();
-		app.exec();
-
-		mainWindow.writeSettingsToLocal();
-	}
-	catch (const std::exception& ex)
-	{
-		qFatal("Exception (%s): %s", typeid(ex).name(), ex.what());
-	}
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <typeinfo>
+
+#include <QApplication>
+#include <QGuiApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QFontDatabase>
+
+#include "MainWindow.h"
+#include "BatchEncoder.h"
+#include "SimpleLogger.h"
+
+namespace
+{
+	OrientView::SimpleLogger logger;
+
+	void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+	{
+		logger.handleMessage(type, context, message);
+	}
+
+	void initializeApplication()
+	{
+		QDir::setCurrent(QCoreApplication::applicationDirPath());
+
+		logger.initialize("orientview.log");
+		qInstallMessageHandler(messageHandler);
+
+		QFontDatabase::addApplicationFont("data/fonts/dejavu-sans-bold.ttf");
+	}
+
+	// orientview --encode settings.orv [--out output.mp4]
+	int runBatchEncode(int argc, char *argv[])
+	{
+		QString settingsFilePath;
+		QString outputFilePath;
+
+		// the paths are relative to the directory the program was started from
+		for (int i = 1; i < argc - 1; ++i)
+		{
+			if (QString(argv[i]) == "--encode")
+				settingsFilePath = QFileInfo(QString(argv[++i])).absoluteFilePath();
+			else if (QString(argv[i]) == "--out")
+				outputFilePath = QFileInfo(QString(argv[++i])).absoluteFilePath();
+		}
+
+		// no widgets are created, with the CPU renderer this also runs on the offscreen platform plugin
+		QGuiApplication app(argc, argv);
+
+		initializeApplication();
+
+		if (settingsFilePath.isEmpty())
+		{
+			qWarning("Usage: orientview --encode settings.orv [--out output.mp4]");
+			return 1;
+		}
+
+		OrientView::BatchEncoder batchEncoder;
+
+		if (!batchEncoder.initialize(settingsFilePath, outputFilePath))
+		{
+			qWarning("Could not initialize batch encoder");
+			return 1;
+		}
+
+		return batchEncoder.run();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		bool isBatchEncode = (argc >= 2 && QString(argv[1]) == "--encode");
+
+		QCoreApplication::setOrganizationDomain("orientview.com");
+		
+#ifdef Q_OS_WIN32
+		QCoreApplication::setOrganizationName("OrientView");
+		QCoreApplication::setApplicationName("OrientView");
+		QCoreApplication::addLibraryPath("data/plugins");
+#else
+		QCoreApplication::setOrganizationName("orientview");
+		QCoreApplication::setApplicationName("orientview");
+#endif
+		
+		if (isBatchEncode)
+			return runBatchEncode(argc, argv);
+
+		QApplication app(argc, argv);
+
+		initializeApplication();
+
+		OrientView::MainWindow mainWindow;
+
+		logger.setMainWindow(&mainWindow);
+
+		if (argc >= 2 && QFile::exists(QString(argv[1])))
+			mainWindow.readSettingsFromIniFile(QString(argv[1]));
+		else
+			mainWindow.readSettingsFromLocal();
+
+		mainWindow.show();
+		app.exec();
+
+		mainWindow.writeSettingsToLocal();
+	}
+	catch (const std::exception& ex)
+	{
+		qFatal("Exception (%s): %s", typeid(ex).name(), ex.what());
+	}
+
+	return 0;
+}
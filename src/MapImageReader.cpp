@@ -1,37 +1,109 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include "MapImageReader.h"
-#include "Settings.h"
-
-using namespace OrientView;
-
-bool MapImageReader::initialize(Settings* settings)
-{
-	qDebug("Initializing map image reader (%s)", qPrintable(settings->map.imageFilePath));
-
-	QImage tempImage;
-
-	if (!tempImage.load(settings->map.imageFilePath))
-	{
-		qWarning("Could not load map image");
-
-		mapImage = QImage(1024, 1024, QImage::Format::Format_ARGB32);
-		mapImage.fill(Qt::red);
-
-		return false;
-	}
-	else
-	{
-		if (settings->map.headerCrop > 0 && tempImage.height() > settings->map.headerCrop)
-			tempImage = tempImage.copy(0, settings->map.headerCrop, tempImage.width(), tempImage.height() - settings->map.headerCrop);
-
-		mapImage = tempImage;
-		return true;
-	}
-}
-
-QImage MapImageReader::getMapImage() const
-{
-	return mapImage;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "MapImageReader.h"
+#include "Settings.h"
+
+using namespace OrientView;
+
+bool MapImageReader::initialize(Settings* settings)
+{
+	qDebug("Initializing map image reader (%s)", qPrintable(settings->map.imageFilePath));
+
+	tileSize = std::max(1, settings->map.tileSize);
+
+	QImage tempImage;
+
+	if (!tempImage.load(settings->map.imageFilePath))
+	{
+		qWarning("Could not load map image");
+
+		tempImage = QImage(1024, 1024, QImage::Format::Format_ARGB32);
+		tempImage.fill(Qt::red);
+
+		generateTiles(tempImage);
+
+		return false;
+	}
+	else
+	{
+		if (settings->map.headerCrop > 0 && tempImage.height() > settings->map.headerCrop)
+			tempImage = tempImage.copy(0, settings->map.headerCrop, tempImage.width(), tempImage.height() - settings->map.headerCrop);
+
+		generateTiles(tempImage);
+
+		return true;
+	}
+}
+
+int MapImageReader::getMapWidth() const
+{
+	return mapWidth;
+}
+
+int MapImageReader::getMapHeight() const
+{
+	return mapHeight;
+}
+
+int MapImageReader::getLevelCount() const
+{
+	return (int)levels.size();
+}
+
+int MapImageReader::getMaxTileImageSize() const
+{
+	return tileSize + 2 * tileBorder;
+}
+
+const std::vector<MapTile>& MapImageReader::getTiles(int level) const
+{
+	return levels.at(level);
+}
+
+// Splits the image into tiles, halves the resolution and repeats until the whole image fits into one tile.
+void MapImageReader::generateTiles(const QImage& mapImage)
+{
+	mapWidth = mapImage.width();
+	mapHeight = mapImage.height();
+
+	levels.clear();
+
+	QImage levelImage = mapImage;
+
+	while (true)
+	{
+		std::vector<MapTile> tiles;
+
+		double scaleX = (double)mapWidth / levelImage.width();
+		double scaleY = (double)mapHeight / levelImage.height();
+
+		for (int y = 0; y < levelImage.height(); y += tileSize)
+		{
+			for (int x = 0; x < levelImage.width(); x += tileSize)
+			{
+				int width = std::min(tileSize, levelImage.width() - x);
+				int height = std::min(tileSize, levelImage.height() - y);
+
+				QRect borderRect = QRect(x - tileBorder, y - tileBorder, width + 2 * tileBorder, height + 2 * tileBorder).intersected(levelImage.rect());
+
+				MapTile tile;
+				// the texture upload and the CPU compositor both use RGBA, so the pyramid is the only copy of the pixels
+				tile.image = levelImage.copy(borderRect).convertToFormat(QImage::Format_RGBA8888);
+				tile.imageRect = QRect(x - borderRect.x(), y - borderRect.y(), width, height);
+				tile.mapRect = QRectF(x * scaleX, y * scaleY, width * scaleX, height * scaleY);
+
+				tiles.push_back(tile);
+			}
+		}
+
+		levels.push_back(tiles);
+
+		if (levelImage.width() <= tileSize && levelImage.height() <= tileSize)
+			break;
+
+		levelImage = levelImage.scaled((levelImage.width() + 1) / 2, (levelImage.height() + 1) / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	}
+
+	qDebug("Map image split into %d levels of %dx%d tiles", (int)levels.size(), tileSize, tileSize);
+}
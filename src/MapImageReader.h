@@ -1,26 +1,48 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QImage>
-
-namespace OrientView
-{
-	class Settings;
-
-	// Read image data from normal image files.
-	class MapImageReader
-	{
-
-	public:
-
-		bool initialize(Settings* settings);
-
-		QImage getMapImage() const;
-
-	private:
-
-		QImage mapImage;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include <QImage>
+#include <QRect>
+
+namespace OrientView
+{
+	class Settings;
+
+	// One piece of the map image at some level of the mip pyramid.
+	struct MapTile
+	{
+		QImage image; // RGBA tile pixels, including the border shared with the neighbouring tiles
+		QRect imageRect; // the part of the image the tile covers, excluding the border
+		QRectF mapRect; // the covered area in full resolution map pixels
+	};
+
+	// Read image data from normal image files.
+	class MapImageReader
+	{
+
+	public:
+
+		bool initialize(Settings* settings);
+
+		int getMapWidth() const;
+		int getMapHeight() const;
+		int getLevelCount() const;
+		int getMaxTileImageSize() const;
+		const std::vector<MapTile>& getTiles(int level) const;
+
+	private:
+
+		void generateTiles(const QImage& mapImage);
+
+		int mapWidth = 0;
+		int mapHeight = 0;
+		int tileSize = 0;
+		int tileBorder = 2; // enough for the bicubic shader to sample across the tile edges without seams
+
+		std::vector<std::vector<MapTile>> levels;
+	};
+}
@@ -0,0 +1,112 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <QElapsedTimer>
+
+#include "PipelineQueue.h"
+
+using namespace OrientView;
+
+void PipelineQueue::initialize(int capacity)
+{
+	this->capacity = capacity;
+
+	statistics.capacity = capacity;
+	freeSemaphore.release(capacity);
+}
+
+// Called by the producer after the last push, the consumer gets the remaining items before tryPop returns nullptr.
+void PipelineQueue::finish()
+{
+	isFinished.storeRelease(1);
+	availableSemaphore.release(1);
+}
+
+// Wakes up both sides and makes all further waits return immediately.
+void PipelineQueue::abort()
+{
+	isAborted.storeRelease(1);
+	freeSemaphore.release(1);
+	availableSemaphore.release(1);
+}
+
+// Items in the queue right now. Can be one too high after finish or abort, which is fine for displaying.
+int PipelineQueue::getOccupancy()
+{
+	return availableSemaphore.available();
+}
+
+PipelineQueueStatistics PipelineQueue::getStatistics()
+{
+	QMutexLocker locker(&statisticsMutex);
+
+	PipelineQueueStatistics currentStatistics = statistics;
+	currentStatistics.averageOccupancy = (statistics.itemCount > 0) ? occupancySum / statistics.itemCount : 0.0;
+
+	return currentStatistics;
+}
+
+int PipelineQueue::acquireFreeSlot()
+{
+	QElapsedTimer waitTimer;
+	waitTimer.start();
+
+	freeSemaphore.acquire(1);
+
+	double waitTime = waitTimer.nsecsElapsed() / 1000000.0;
+
+	// pass the wake up on to the other waits
+	if (isAborted.loadAcquire())
+	{
+		freeSemaphore.release(1);
+		return -1;
+	}
+
+	QMutexLocker locker(&statisticsMutex);
+	statistics.producerWaitTime += waitTime;
+
+	return writeIndex;
+}
+
+void PipelineQueue::pushSlot()
+{
+	writeIndex = (writeIndex + 1) % capacity;
+	pushCount++;
+
+	availableSemaphore.release(1);
+
+	QMutexLocker locker(&statisticsMutex);
+	statistics.itemCount++;
+	occupancySum += availableSemaphore.available();
+}
+
+int PipelineQueue::tryPopSlot(int timeout)
+{
+	QElapsedTimer waitTimer;
+	waitTimer.start();
+
+	if (!availableSemaphore.tryAcquire(1, timeout))
+		return -1;
+
+	double waitTime = waitTimer.nsecsElapsed() / 1000000.0;
+
+	// the extra release from finish or abort is not an item, so leave it for the next waits
+	if (isAborted.loadAcquire() || (isFinished.loadAcquire() && popCount == pushCount))
+	{
+		availableSemaphore.release(1);
+		return -1;
+	}
+
+	QMutexLocker locker(&statisticsMutex);
+	statistics.consumerWaitTime += waitTime;
+
+	return readIndex;
+}
+
+void PipelineQueue::releaseSlot()
+{
+	readIndex = (readIndex + 1) % capacity;
+	popCount++;
+
+	freeSemaphore.release(1);
+}
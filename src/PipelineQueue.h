@@ -0,0 +1,112 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QAtomicInt>
+
+namespace OrientView
+{
+	// Counters for finding out which side of a queue is the bottleneck.
+	struct PipelineQueueStatistics
+	{
+		int capacity = 0;
+		int64_t itemCount = 0; // items passed through the queue
+		double averageOccupancy = 0.0; // items in the queue after a push
+		double producerWaitTime = 0.0; // milliseconds spent waiting for a free slot
+		double consumerWaitTime = 0.0; // milliseconds spent waiting for an item
+	};
+
+	// Bounded queue between one producer and one consumer thread. Blocked waits are woken up by finish and abort, so nothing needs to poll.
+	class PipelineQueue
+	{
+
+	public:
+
+		virtual ~PipelineQueue() {}
+
+		void finish();
+		void abort();
+
+		int getOccupancy();
+		PipelineQueueStatistics getStatistics();
+
+	protected:
+
+		void initialize(int capacity);
+
+		int acquireFreeSlot();
+		void pushSlot();
+		int tryPopSlot(int timeout);
+		void releaseSlot();
+
+	private:
+
+		QSemaphore freeSemaphore;
+		QSemaphore availableSemaphore;
+		QAtomicInt isFinished;
+		QAtomicInt isAborted;
+
+		int capacity = 0;
+		int writeIndex = 0;
+		int readIndex = 0;
+		int64_t pushCount = 0; // only written by the producer
+		int64_t popCount = 0; // only written by the consumer
+
+		QMutex statisticsMutex;
+		PipelineQueueStatistics statistics;
+		double occupancySum = 0.0;
+	};
+
+	// Pipeline queue with preallocated slots of type T that are filled and read in place.
+	template <typename T>
+	class PipelineSlotQueue : public PipelineQueue
+	{
+
+	public:
+
+		void initialize(int capacity)
+		{
+			slots.resize((size_t)capacity);
+			PipelineQueue::initialize(capacity);
+		}
+
+		// Blocks until the consumer has released a slot. Returns nullptr if the queue was aborted.
+		T* acquire()
+		{
+			int index = acquireFreeSlot();
+			return (index >= 0) ? &slots[(size_t)index] : nullptr;
+		}
+
+		void push()
+		{
+			pushSlot();
+		}
+
+		// A negative timeout blocks. Returns nullptr on timeout, after the last item of a finished queue, or if the queue was aborted.
+		T* tryPop(int timeout)
+		{
+			int index = tryPopSlot(timeout);
+			return (index >= 0) ? &slots[(size_t)index] : nullptr;
+		}
+
+		void release()
+		{
+			releaseSlot();
+		}
+
+		std::vector<T>& getSlots()
+		{
+			return slots;
+		}
+
+	private:
+
+		std::vector<T> slots;
+	};
+}
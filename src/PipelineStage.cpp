@@ -0,0 +1,53 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "PipelineStage.h"
+#include "PipelineQueue.h"
+
+using namespace OrientView;
+
+void PipelineStage::togglePaused()
+{
+	QMutexLocker locker(&pauseMutex);
+
+	isPaused = !isPaused;
+	pauseCondition.wakeAll();
+}
+
+bool PipelineStage::getIsPaused()
+{
+	QMutexLocker locker(&pauseMutex);
+
+	return isPaused;
+}
+
+// Requests interruption and wakes up the thread from any pause or queue wait. Call wait afterwards.
+void PipelineStage::stop()
+{
+	requestInterruption();
+
+	pauseMutex.lock();
+	isPaused = false;
+	pauseCondition.wakeAll();
+	pauseMutex.unlock();
+
+	for (PipelineQueue* queue : queues)
+		queue->abort();
+}
+
+// Registers an input or output queue to be aborted when the stage is stopped.
+void PipelineStage::addQueue(PipelineQueue* queue)
+{
+	queues.push_back(queue);
+}
+
+// Returns false if the stage was stopped.
+bool PipelineStage::waitWhilePaused()
+{
+	QMutexLocker locker(&pauseMutex);
+
+	while (isPaused && !isInterruptionRequested())
+		pauseCondition.wait(&pauseMutex);
+
+	return !isInterruptionRequested();
+}
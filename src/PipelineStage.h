@@ -0,0 +1,40 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace OrientView
+{
+	class PipelineQueue;
+
+	// Thread of the video processing pipeline, which can be paused and stopped without polling.
+	class PipelineStage : public QThread
+	{
+
+	public:
+
+		void togglePaused();
+		bool getIsPaused();
+
+		virtual void stop();
+
+	protected:
+
+		void addQueue(PipelineQueue* queue);
+		bool waitWhilePaused();
+
+	private:
+
+		std::vector<PipelineQueue*> queues;
+
+		QMutex pauseMutex;
+		QWaitCondition pauseCondition;
+		bool isPaused = false;
+	};
+}
@@ -1,447 +1,666 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#define _USE_MATH_DEFINES
-#include <cmath>
-#include <cstdint>
-
-#include "QuickRouteReader.h"
-#include "MapImageReader.h"
-#include "Settings.h"
-
-using namespace OrientView;
-
-bool QuickRouteReader::initialize(MapImageReader* mapImageReader, Settings* settings)
-{
-	qDebug("Initializing QuickRoute reader (%s)", qPrintable(settings->route.quickRouteJpegFilePath));
-
-	mapImageWidth = mapImageReader->getMapImage().width();
-	mapImageHeight = mapImageReader->getMapImage().height();
-
-	QFile file(settings->route.quickRouteJpegFilePath);
-
-	if (!file.open(QIODevice::ReadOnly))
-	{
-		qWarning("Could not open the file");
-		return false;
-	}
-
-	QByteArray buffer;
-
-	if (!extractDataPartFromJpeg(file, buffer))
-		return false;
-
-	QDataStream dataStream(buffer);
-	dataStream.setByteOrder(QDataStream::LittleEndian);
-
-	processDataPart(dataStream);
-
-	if (projectionOriginCoordinate.isNull())
-	{
-		qWarning("Could not find projection origin");
-		return false;
-	}
-
-	processRoutePoints();
-
-	return true;
-}
-
-const std::vector<RoutePoint>& QuickRouteReader::getRoutePoints() const
-{
-	return routePoints;
-}
-
-bool QuickRouteReader::extractDataPartFromJpeg(QFile& file, QByteArray& buffer)
-{
-	const int quickRouteIdLength = 10;
-	char quickRouteId[quickRouteIdLength] { 0x51, 0x75, 0x69, 0x63, 0x6b, 0x52, 0x6f, 0x75, 0x74, 0x65 };
-	QByteArray quickRouteIdBuffer(quickRouteId, quickRouteIdLength);
-	QByteArray readBuffer;
-
-	if (!readBytes(file, readBuffer, 2))
-		return false;
-
-	if ((uint8_t)readBuffer.at(0) != 0xff || (uint8_t)readBuffer.at(1) != 0xd8)
-	{
-		qWarning("Not a supported JPEG file format");
-		return false;
-	}
-
-	while ((file.size() - file.pos()) >= 2)
-	{
-		if (!readBytes(file, readBuffer, 2))
-			return false;
-
-		if ((uint8_t)readBuffer.at(0) != 0xff)
-		{
-			qWarning("Could not find QuickRoute Jpeg Extension Data");
-			return false;
-		}
-
-		if ((uint8_t)readBuffer.at(1) == 0xe0)
-		{
-			if (!readBytes(file, readBuffer, 2))
-				return false;
-
-			uint32_t length = (uint8_t)readBuffer.at(1) + 256 * (uint8_t)readBuffer.at(0);
-
-			if (length >= (quickRouteIdLength + 2))
-			{
-				if (!readBytes(file, readBuffer, quickRouteIdLength))
-					return false;
-
-				bool match = readBuffer.startsWith(quickRouteIdBuffer);
-
-				if (!readBytes(file, readBuffer, length - 2 - quickRouteIdLength))
-					return false;
-
-				if (match)
-				{
-					buffer = readBuffer;
-					return true;
-				}
-			}
-			else
-			{
-				if (!readBytes(file, readBuffer, length - 2))
-					return false;
-			}
-
-		}
-	}
-
-	qWarning("Could not find QuickRoute Jpeg Extension Data");
-	return false;
-}
-
-bool QuickRouteReader::readBytes(QFile& file, QByteArray& buffer, int count)
-{
-	if ((file.size() - file.pos()) < count)
-	{
-		qWarning("Could not read enough bytes");
-		return false;
-	}
-
-	buffer = file.read(count);
-
-	return true;
-}
-
-void QuickRouteReader::processDataPart(QDataStream& dataStream)
-{
-	while (!dataStream.atEnd())
-	{
-		uint8_t tag;
-		uint32_t tagLength;
-
-		dataStream >> tag;
-		dataStream >> tagLength;
-
-		if (tag == 5) // sessions
-		{
-			uint32_t sessionCount;
-			dataStream >> sessionCount;
-
-			for (uint32_t i = 0; i < sessionCount; i++)
-			{
-				dataStream >> tag;
-				dataStream >> tagLength;
-
-				if (tag == 6) // session
-					readSession(dataStream, tagLength);
-				else
-					dataStream.skipRawData(tagLength);
-			}
-		}
-		else if (tag == 4) // image dimensions
-		{
-			uint16_t x, y, width, height;
-
-			dataStream >> x;
-			dataStream >> y;
-			dataStream >> width;
-			dataStream >> height;
-
-			quickRouteImageWidth = width;
-			quickRouteImageHeight = height;
-		}
-		else
-			dataStream.skipRawData(tagLength);
-	}
-}
-
-void QuickRouteReader::readSession(QDataStream& dataStream, uint32_t length)
-{
-	uint32_t readLength = 0;
-
-	do
-	{
-		uint8_t tag;
-		uint32_t tagLength;
-
-		dataStream >> tag;
-		dataStream >> tagLength;
-
-		if (tag == 7) // route
-			readRoute(dataStream);
-		else if (tag == 8) // handles
-			readHandles(dataStream);
-		else if (tag == 9) // projection origin
-		{
-			double lon = readCoordinate(dataStream);
-			double lat = readCoordinate(dataStream);
-
-			projectionOriginCoordinate.setX(lon);
-			projectionOriginCoordinate.setY(lat);
-		}
-		else
-			dataStream.skipRawData(tagLength);
-
-		readLength += (1 + 4 + tagLength);
-
-	} while (readLength < length);
-}
-
-void QuickRouteReader::readRoute(QDataStream& dataStream)
-{
-	uint16_t attributes, extraWaypointAttributesLength;
-	uint32_t segmentCount;
-
-	dataStream >> attributes;
-	dataStream >> extraWaypointAttributesLength;
-	dataStream >> segmentCount;
-
-	QDateTime previousTime = QDateTime::fromMSecsSinceEpoch(0);
-
-	for (uint32_t i = 0; i < segmentCount; i++)
-	{
-		uint32_t waypointCount;
-		dataStream >> waypointCount;
-
-		for (uint32_t j = 0; j < waypointCount; j++)
-		{
-			RoutePoint rp;
-
-			double lon = readCoordinate(dataStream);
-			double lat = readCoordinate(dataStream);
-
-			rp.coordinate.setX(lon);
-			rp.coordinate.setY(lat);
-
-			rp.dateTime = readDateTime(dataStream, previousTime);
-			previousTime = rp.dateTime;
-
-			// heart rate
-			if (attributes & 0x04)
-			{
-				uint8_t heartRate;
-				dataStream >> heartRate;
-				rp.heartRate = heartRate;
-			}
-
-			// elevation
-			if (attributes & 0x08)
-			{
-				uint16_t elevation;
-				dataStream >> elevation;
-				rp.elevation = elevation;
-			}
-
-			// only use the first segment for now
-			if (i == 0)
-				routePoints.push_back(rp);
-
-			dataStream.skipRawData(extraWaypointAttributesLength);
-		}
-	}
-}
-
-void QuickRouteReader::readHandles(QDataStream& dataStream)
-{
-	uint32_t handleCount;
-	dataStream >> handleCount;
-
-	for (uint32_t i = 0; i < handleCount; i++)
-	{
-		RoutePointHandle rph;
-		double matrix[9];
-
-		for (int j = 0; j < 9; j++)
-			dataStream >> matrix[j];
-
-		uint32_t segmentIndex;
-		dataStream >> segmentIndex;
-
-		double routePointIndex;
-		dataStream >> routePointIndex;
-
-		rph.routePointIndex = routePointIndex;
-		rph.transformation.setMatrix(matrix[0], matrix[1], matrix[3], matrix[4], matrix[2], matrix[5]);
-
-		// only use the first segment for now
-		if (segmentIndex == 0)
-			routePointHandles.push_back(rph);
-
-		// ignore handle pixel location and type
-		dataStream.skipRawData(18);
-	}
-}
-
-double QuickRouteReader::readCoordinate(QDataStream& dataStream)
-{
-	uint32_t tempValue;
-	dataStream >> tempValue;
-
-	return (((double)((int32_t)tempValue)) / 3600000.0);
-}
-
-QDateTime QuickRouteReader::readDateTime(QDataStream& dataStream, QDateTime& previous)
-{
-	uint8_t timeType;
-	dataStream >> timeType;
-
-	if (timeType == 0) // absolute
-	{
-		quint64 timeValue;
-		dataStream >> timeValue;		 // .NET DateTime serialized value
-		timeValue &= 0x3FFFFFFFFFFFFFFF; // remove kind data
-		timeValue -= 621355968000000000; // offset to epoch start
-		timeValue /= 10000;				 // convert to ms
-
-		return QDateTime::fromMSecsSinceEpoch(timeValue);
-	}
-	else // relative
-	{
-		uint16_t timeValue;
-		dataStream >> timeValue; // ms
-
-		return previous.addMSecs(timeValue);
-	}
-}
-
-void QuickRouteReader::processRoutePoints()
-{
-	if (routePoints.size() < 1)
-		return;
-
-	size_t handleIndex = 0;
-	RoutePointHandle currentHandle;
-	RoutePointHandle nextHandle;
-	nextHandle.routePointIndex = std::numeric_limits<double>::max();
-
-	if (handleIndex < routePointHandles.size())
-		currentHandle = routePointHandles.at(handleIndex);
-
-	if (++handleIndex < routePointHandles.size())
-		nextHandle = routePointHandles.at(handleIndex);
-
-	// move origin to the center and scale points if map images have different dimensions
-	QMatrix extraTransformation;
-	extraTransformation.scale(mapImageWidth / quickRouteImageWidth, mapImageHeight / quickRouteImageHeight);
-	extraTransformation.translate(quickRouteImageWidth / -2.0, quickRouteImageHeight / -2.0);
-
-	// transform points using the previous handle
-	// use first handle if no previous handle
-	// do not use the last handle at all (use second to last handle instead for the last points)
-	for (size_t i = 0; i < routePoints.size(); ++i)
-	{
-		if ((double)i > nextHandle.routePointIndex)
-		{
-			if (++handleIndex < routePointHandles.size())
-			{
-				currentHandle = nextHandle;
-				nextHandle = routePointHandles.at(handleIndex);
-			}
-			else
-				nextHandle.routePointIndex = std::numeric_limits<double>::max();
-		}
-
-		QPointF position = projectCoordinate(routePoints.at(i).coordinate, projectionOriginCoordinate);;
-		position = currentHandle.transformation.map(position);
-		routePoints.at(i).position = extraTransformation.map(position);
-	}
-
-	if (routePoints.size() < 2)
-		return;
-
-	// calculate cumulative time, delta times, delta distances, and paces
-	for (size_t i = 1; i < routePoints.size(); ++i)
-	{
-		routePoints.at(i).time = (routePoints.at(i).dateTime.toMSecsSinceEpoch() - routePoints.at(0).dateTime.toMSecsSinceEpoch()) / 1000.0;
-
-		double timeToPrevious = (routePoints.at(i).dateTime.toMSecsSinceEpoch() - routePoints.at(i - 1).dateTime.toMSecsSinceEpoch()) / 1000.0;
-		double distanceToPrevious = coordinateDistance(routePoints.at(i - 1).coordinate, routePoints.at(i).coordinate);
-
-		if (distanceToPrevious > 0.0)
-			routePoints.at(i).pace = (timeToPrevious / 60.0) / (distanceToPrevious / 1000.0);
-	}
-
-	double currentAngle = 0.0;
-
-	// calculate orientations
-	for (size_t i = 0; i < routePoints.size() - 1; ++i)
-	{
-		RoutePoint& rp1 = routePoints.at(i);
-		RoutePoint& rp2 = routePoints.at(i + 1);
-
-		QPointF firstToSecond = rp2.position - rp1.position;
-
-		double angle = atan2(-firstToSecond.y(), firstToSecond.x()) * (180.0 / M_PI);
-		angle = 90.0 - angle;
-
-		if (angle > 180.0)
-			angle = angle - 360.0;
-
-		double angleDelta = angle - currentAngle;
-		double finalAngleDelta = angleDelta;
-
-		while (abs(finalAngleDelta) > 360.0)
-			finalAngleDelta += (finalAngleDelta > 0.0) ? -360.0 : 360.0;
-
-		if (abs(finalAngleDelta) > 180.0)
-		{
-			finalAngleDelta = 360.0 - abs(finalAngleDelta);
-			finalAngleDelta *= (angleDelta < 0.0) ? 1.0 : -1.0;
-		}
-
-		currentAngle += finalAngleDelta;
-		rp1.orientation = currentAngle;
-	}
-
-	routePoints.back().orientation = currentAngle;
-}
-
-QPointF QuickRouteReader::projectCoordinate(const QPointF& coordinate, const QPointF& projectionOriginCoordinate)
-{
-	// http://en.wikipedia.org/wiki/Orthographic_projection_%28cartography%29
-	const double R = 6378200.0;
-
-	double lambda0 = projectionOriginCoordinate.x() * M_PI / 180.0;
-	double phi0 = projectionOriginCoordinate.y() * M_PI / 180.0;
-	double lambda = coordinate.x() * M_PI / 180.0;
-	double phi = coordinate.y() * M_PI / 180.0;
-
-	QPointF position;
-
-	position.setX(R * cos(phi) * sin(lambda - lambda0));
-	position.setY(R * (cos(phi0) * sin(phi) - sin(phi0) * cos(phi) * cos(lambda - lambda0)));
-
-	return position;
-}
-
-double QuickRouteReader::coordinateDistance(const QPointF& coordinate1, const QPointF& coordinate2)
-{
-	// http://en.wikipedia.org/wiki/Haversine_formula
-	const double R = 6378200.0;
-
-	double lat1 = coordinate1.y() * M_PI / 180.0;
-	double lat2 = coordinate2.y() * M_PI / 180.0;
-	double deltaLon = (coordinate2.x() - coordinate1.x()) * M_PI / 180.0;
-	double deltaLat = (coordinate2.y() - coordinate1.y()) * M_PI / 180.0;
-
-	double a = pow(sin(deltaLat / 2.0), 2.0) + cos(lat1) * cos(lat2) * pow(sin(deltaLon / 2.0), 2.0);
-	double distance = 2.0 * R * atan2(sqrt(a), sqrt(1.0 - a));
-
-	return distance;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include <QStringList>
+#include <QFileInfo>
+#include <QRegExp>
+
+#include "QuickRouteReader.h"
+#include "ByteReader.h"
+#include "GpxReader.h"
+#include "MapImageReader.h"
+#include "Settings.h"
+
+using namespace OrientView;
+
+QuickRouteReader::~QuickRouteReader()
+{
+	for (QuickRouteReader* runnerRouteReader : runnerRouteReaders)
+		delete runnerRouteReader;
+}
+
+bool QuickRouteReader::initialize(MapImageReader* mapImageReader, Settings* settings)
+{
+	mapImageWidth = mapImageReader->getMapWidth();
+	mapImageHeight = mapImageReader->getMapHeight();
+	sampleRate = std::max(1, settings->route.sampleRate);
+
+	// a GPS track file replaces the route of the QuickRoute file
+	if (!settings->route.trackFilePath.isEmpty())
+	{
+		if (!readTrackFile(settings->route.trackFilePath, settings->route.trackGeoreference))
+			return false;
+	}
+	else if (!readQuickRouteFile(settings->route.quickRouteJpegFilePath))
+		return false;
+
+	// the other runners are on the same map, so their GPS tracks use the same georeference
+	for (const Settings::Runner& runner : settings->runners)
+	{
+		QuickRouteReader* runnerRouteReader = new QuickRouteReader();
+		runnerRouteReaders.push_back(runnerRouteReader);
+
+		runnerRouteReader->mapImageWidth = mapImageWidth;
+		runnerRouteReader->mapImageHeight = mapImageHeight;
+		runnerRouteReader->sampleRate = sampleRate;
+
+		QString suffix = QFileInfo(runner.filePath).suffix().toLower();
+		bool isTrackFile = (suffix == "gpx" || suffix == "tcx");
+
+		if (isTrackFile ? !runnerRouteReader->readTrackFile(runner.filePath, settings->route.trackGeoreference) : !runnerRouteReader->readQuickRouteFile(runner.filePath))
+		{
+			qWarning("Could not read the route of runner %s", qPrintable(runner.name));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const std::vector<RoutePoint>& QuickRouteReader::getRoutePoints() const
+{
+	return routePoints;
+}
+
+int QuickRouteReader::getRunnerCount() const
+{
+	return (int)runnerRouteReaders.size();
+}
+
+QuickRouteReader* QuickRouteReader::getRunnerRouteReader(int index) const
+{
+	return runnerRouteReaders.at(index);
+}
+
+bool QuickRouteReader::readQuickRouteFile(const QString& filePath)
+{
+	qDebug("Initializing QuickRoute reader (%s)", qPrintable(filePath));
+
+	QFile file(filePath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		qWarning("Could not open the file");
+		return false;
+	}
+
+	// the file is only read through the mapping, which stays valid until the file is closed
+	size_t fileSize = (size_t)file.size();
+	const uint8_t* fileData = (fileSize > 0) ? file.map(0, file.size()) : nullptr;
+
+	if (fileData == nullptr)
+	{
+		qWarning("Could not map the file");
+		return false;
+	}
+
+	// the whole processed route is in the cache if the file and the settings have not changed
+	if (routeCache.initialize(filePath, fileData, fileSize, QString(), (int)mapImageWidth, (int)mapImageHeight, sampleRate) && routeCache.read(routePoints, cachedRouteTrack))
+	{
+		qDebug("Using the route cache");
+
+		isReadFromCache = true;
+		return true;
+	}
+
+	const uint8_t* dataPart = nullptr;
+	size_t dataPartSize = 0;
+
+	if (!extractDataPartFromJpeg(fileData, fileSize, dataPart, dataPartSize))
+		return false;
+
+	ByteReader byteReader(dataPart, dataPartSize);
+
+	processDataPart(byteReader);
+
+	if (byteReader.hasError())
+	{
+		qWarning("QuickRoute data is truncated");
+		return false;
+	}
+
+	if (projectionOriginCoordinate.isNull())
+	{
+		qWarning("Could not find projection origin");
+		return false;
+	}
+
+	processRoutePoints();
+
+	return true;
+}
+
+// Reads the route from a GPX or TCX file. The georeference maps the latitudes and longitudes to map pixels.
+bool QuickRouteReader::readTrackFile(const QString& filePath, const QString& georeferenceText)
+{
+	qDebug("Initializing GPS track reader (%s)", qPrintable(filePath));
+
+	QMatrix georeference;
+
+	if (!parseGeoreference(georeferenceText, georeference))
+		return false;
+
+	QFile file(filePath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		qWarning("Could not open the file");
+		return false;
+	}
+
+	size_t fileSize = (size_t)file.size();
+	const uint8_t* fileData = (fileSize > 0) ? file.map(0, file.size()) : nullptr;
+
+	if (fileData == nullptr)
+	{
+		qWarning("Could not map the file");
+		return false;
+	}
+
+	if (routeCache.initialize(filePath, fileData, fileSize, georeferenceText, (int)mapImageWidth, (int)mapImageHeight, sampleRate) && routeCache.read(routePoints, cachedRouteTrack))
+	{
+		qDebug("Using the route cache");
+
+		isReadFromCache = true;
+		return true;
+	}
+
+	GpxReader gpxReader;
+
+	if (!gpxReader.read(fileData, fileSize))
+		return false;
+
+	const std::vector<TrackPoint>& trackPoints = gpxReader.getTrackPoints();
+
+	if (trackPoints.empty())
+	{
+		qWarning("Could not find any track points");
+		return false;
+	}
+
+	routePoints.clear();
+	routePoints.reserve(trackPoints.size());
+
+	// the georeference is in map image pixels, the route positions are relative to the map center
+	QPointF mapCenter(mapImageWidth / 2.0, mapImageHeight / 2.0);
+
+	for (const TrackPoint& trackPoint : trackPoints)
+	{
+		RoutePoint rp;
+
+		rp.dateTime = trackPoint.dateTime;
+		rp.coordinate = QPointF(trackPoint.longitude, trackPoint.latitude);
+		rp.position = georeference.map(QPointF(trackPoint.latitude, trackPoint.longitude)) - mapCenter;
+		rp.elevation = trackPoint.elevation;
+		rp.heartRate = trackPoint.heartRate;
+		rp.segmentIndex = trackPoint.segmentIndex;
+
+		routePoints.push_back(rp);
+	}
+
+	calculateRoutePointValues();
+
+	return true;
+}
+
+// Either six affine coefficients a, b, c, d, e, f with x = a * lat + b * lon + c and y = d * lat + e * lon + f,
+// or three reference points as latitude, longitude, x, y. The numbers can be separated with commas, semicolons or spaces.
+bool QuickRouteReader::parseGeoreference(const QString& text, QMatrix& georeference)
+{
+	QStringList parts = text.split(QRegExp("[,;|\\s]"), QString::SkipEmptyParts);
+	std::vector<double> values;
+
+	for (const QString& part : parts)
+	{
+		bool ok = false;
+		values.push_back(part.toDouble(&ok));
+
+		if (!ok)
+		{
+			qWarning("Invalid number in the track georeference: %s", qPrintable(part));
+			return false;
+		}
+	}
+
+	if (values.size() == 6)
+	{
+		georeference.setMatrix(values[0], values[3], values[1], values[4], values[2], values[5]);
+		return true;
+	}
+
+	if (values.size() != 12)
+	{
+		qWarning("The track georeference needs six affine coefficients or three reference points");
+		return false;
+	}
+
+	// solve the affine transformation going through the three points with Cramer's rule
+	double lat1 = values[0], lon1 = values[1], x1 = values[2], y1 = values[3];
+	double lat2 = values[4], lon2 = values[5], x2 = values[6], y2 = values[7];
+	double lat3 = values[8], lon3 = values[9], x3 = values[10], y3 = values[11];
+
+	double determinant = lat1 * (lon2 - lon3) - lon1 * (lat2 - lat3) + (lat2 * lon3 - lat3 * lon2);
+
+	if (std::abs(determinant) < 1e-12)
+	{
+		qWarning("The track georeference points are on one line");
+		return false;
+	}
+
+	auto solve = [&](double v1, double v2, double v3, double& a, double& b, double& c)
+	{
+		a = (v1 * (lon2 - lon3) - lon1 * (v2 - v3) + (v2 * lon3 - v3 * lon2)) / determinant;
+		b = (lat1 * (v2 - v3) - v1 * (lat2 - lat3) + (lat2 * v3 - lat3 * v2)) / determinant;
+		c = (lat1 * (lon2 * v3 - lon3 * v2) - lon1 * (lat2 * v3 - lat3 * v2) + v1 * (lat2 * lon3 - lat3 * lon2)) / determinant;
+	};
+
+	double a, b, c, d, e, f;
+	solve(x1, x2, x3, a, b, c);
+	solve(y1, y2, y3, d, e, f);
+
+	georeference.setMatrix(a, d, b, e, c, f);
+
+	return true;
+}
+
+// Returns false if the track has not been read from or written to the cache yet and needs to be calculated.
+bool QuickRouteReader::getCachedRouteTrack(RouteTrack& track) const
+{
+	if (!isReadFromCache)
+		return false;
+
+	track = cachedRouteTrack;
+	return true;
+}
+
+// Stores the route points and the calculated track for the next run. The track is also kept in the reader, because the batch encoder shares it between the segment pipelines.
+void QuickRouteReader::writeRouteCache(const RouteTrack& track)
+{
+	if (isReadFromCache)
+		return;
+
+	if (routeCache.write(routePoints, track))
+	{
+		cachedRouteTrack = track;
+		isReadFromCache = true;
+	}
+}
+
+// Walks the JPEG segments in place until the start of the image data. The QuickRoute data is in an APP0 segment.
+bool QuickRouteReader::extractDataPartFromJpeg(const uint8_t* data, size_t size, const uint8_t*& dataPart, size_t& dataPartSize)
+{
+	const size_t quickRouteIdLength = 10;
+	const uint8_t quickRouteId[quickRouteIdLength] { 0x51, 0x75, 0x69, 0x63, 0x6b, 0x52, 0x6f, 0x75, 0x74, 0x65 };
+
+	if (size < 2 || data[0] != 0xff || data[1] != 0xd8)
+	{
+		qWarning("Not a supported JPEG file format");
+		return false;
+	}
+
+	size_t position = 2;
+
+	while (size - position >= 2)
+	{
+		if (data[position] != 0xff)
+		{
+			qWarning("Invalid JPEG segment marker");
+			return false;
+		}
+
+		uint8_t marker = data[position + 1];
+		position += 2;
+
+		// fill bytes before a marker
+		if (marker == 0xff)
+		{
+			position--;
+			continue;
+		}
+
+		// the image data starts, no more metadata segments after this
+		if (marker == 0xda || marker == 0xd9)
+			break;
+
+		// markers without a length
+		if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7))
+			continue;
+
+		if (size - position < 2)
+			break;
+
+		size_t length = ((size_t)data[position] << 8) | data[position + 1];
+
+		if (length < 2 || length > size - position)
+		{
+			qWarning("Invalid JPEG segment length");
+			return false;
+		}
+
+		const uint8_t* segment = data + position + 2;
+		size_t segmentSize = length - 2;
+
+		if (marker == 0xe0 && segmentSize >= quickRouteIdLength && memcmp(segment, quickRouteId, quickRouteIdLength) == 0)
+		{
+			dataPart = segment + quickRouteIdLength;
+			dataPartSize = segmentSize - quickRouteIdLength;
+
+			return true;
+		}
+
+		position += length;
+	}
+
+	qWarning("Could not find QuickRoute Jpeg Extension Data");
+	return false;
+}
+
+void QuickRouteReader::processDataPart(ByteReader& byteReader)
+{
+	while (!byteReader.atEnd())
+	{
+		uint8_t tag = byteReader.readUInt8();
+		uint32_t tagLength = byteReader.readUInt32();
+
+		if (tag == 5) // sessions
+		{
+			uint32_t sessionCount = byteReader.readUInt32();
+
+			for (uint32_t i = 0; i < sessionCount && !byteReader.hasError(); i++)
+			{
+				tag = byteReader.readUInt8();
+				tagLength = byteReader.readUInt32();
+
+				if (tag == 6) // session
+					readSession(byteReader, tagLength);
+				else
+					byteReader.skip(tagLength);
+			}
+		}
+		else if (tag == 4) // image dimensions
+		{
+			byteReader.readUInt16(); // x
+			byteReader.readUInt16(); // y
+			quickRouteImageWidth = byteReader.readUInt16();
+			quickRouteImageHeight = byteReader.readUInt16();
+		}
+		else
+			byteReader.skip(tagLength);
+	}
+}
+
+void QuickRouteReader::readSession(ByteReader& byteReader, uint32_t length)
+{
+	uint32_t readLength = 0;
+
+	do
+	{
+		uint8_t tag = byteReader.readUInt8();
+		uint32_t tagLength = byteReader.readUInt32();
+
+		if (tag == 7) // route
+			readRoute(byteReader);
+		else if (tag == 8) // handles
+			readHandles(byteReader);
+		else if (tag == 9) // projection origin
+		{
+			double lon = readCoordinate(byteReader);
+			double lat = readCoordinate(byteReader);
+
+			projectionOriginCoordinate.setX(lon);
+			projectionOriginCoordinate.setY(lat);
+		}
+		else
+			byteReader.skip(tagLength);
+
+		readLength += (1 + 4 + tagLength);
+
+	} while (readLength < length && !byteReader.hasError());
+}
+
+void QuickRouteReader::readRoute(ByteReader& byteReader)
+{
+	uint16_t attributes = byteReader.readUInt16();
+	uint16_t extraWaypointAttributesLength = byteReader.readUInt16();
+	uint32_t segmentCount = byteReader.readUInt32();
+
+	QDateTime previousTime = QDateTime::fromMSecsSinceEpoch(0);
+
+	for (uint32_t i = 0; i < segmentCount && !byteReader.hasError(); i++)
+	{
+		uint32_t waypointCount = byteReader.readUInt32();
+		segmentFirstIndices.push_back(routePoints.size());
+
+		for (uint32_t j = 0; j < waypointCount && !byteReader.hasError(); j++)
+		{
+			RoutePoint rp;
+
+			double lon = readCoordinate(byteReader);
+			double lat = readCoordinate(byteReader);
+
+			rp.coordinate.setX(lon);
+			rp.coordinate.setY(lat);
+			rp.segmentIndex = (int)i;
+
+			rp.dateTime = readDateTime(byteReader, previousTime);
+			previousTime = rp.dateTime;
+
+			// heart rate
+			if (attributes & 0x04)
+				rp.heartRate = byteReader.readUInt8();
+
+			// elevation
+			if (attributes & 0x08)
+				rp.elevation = byteReader.readUInt16();
+
+			routePoints.push_back(rp);
+
+			byteReader.skip(extraWaypointAttributesLength);
+		}
+	}
+}
+
+void QuickRouteReader::readHandles(ByteReader& byteReader)
+{
+	uint32_t handleCount = byteReader.readUInt32();
+
+	for (uint32_t i = 0; i < handleCount && !byteReader.hasError(); i++)
+	{
+		RoutePointHandle rph;
+		double matrix[9];
+
+		for (int j = 0; j < 9; j++)
+			matrix[j] = byteReader.readDouble();
+
+		uint32_t segmentIndex = byteReader.readUInt32();
+		double routePointIndex = byteReader.readDouble();
+
+		rph.segmentIndex = segmentIndex;
+		rph.routePointIndex = routePointIndex;
+		rph.transformation.setMatrix(matrix[0], matrix[1], matrix[3], matrix[4], matrix[2], matrix[5]);
+
+		routePointHandles.push_back(rph);
+
+		// ignore handle pixel location and type
+		byteReader.skip(18);
+	}
+}
+
+double QuickRouteReader::readCoordinate(ByteReader& byteReader)
+{
+	uint32_t tempValue = byteReader.readUInt32();
+
+	return (((double)((int32_t)tempValue)) / 3600000.0);
+}
+
+QDateTime QuickRouteReader::readDateTime(ByteReader& byteReader, QDateTime& previous)
+{
+	uint8_t timeType = byteReader.readUInt8();
+
+	if (timeType == 0) // absolute
+	{
+		uint64_t timeValue = byteReader.readUInt64(); // .NET DateTime serialized value
+		timeValue &= 0x3FFFFFFFFFFFFFFF; // remove kind data
+		timeValue -= 621355968000000000; // offset to epoch start
+		timeValue /= 10000;				 // convert to ms
+
+		return QDateTime::fromMSecsSinceEpoch(timeValue);
+	}
+	else // relative
+	{
+		uint16_t timeValue = byteReader.readUInt16(); // ms
+
+		return previous.addMSecs(timeValue);
+	}
+}
+
+void QuickRouteReader::processRoutePoints()
+{
+	if (routePoints.size() < 1)
+		return;
+
+	// the handles of all the segments are used in the order of the route points
+	for (RoutePointHandle& rph : routePointHandles)
+	{
+		if (rph.segmentIndex < segmentFirstIndices.size())
+			rph.routePointIndex += (double)segmentFirstIndices.at(rph.segmentIndex);
+	}
+
+	std::stable_sort(routePointHandles.begin(), routePointHandles.end(), [](const RoutePointHandle& rph1, const RoutePointHandle& rph2) { return rph1.routePointIndex < rph2.routePointIndex; });
+
+	size_t handleIndex = 0;
+	RoutePointHandle currentHandle;
+	RoutePointHandle nextHandle;
+	nextHandle.routePointIndex = std::numeric_limits<double>::max();
+
+	if (handleIndex < routePointHandles.size())
+		currentHandle = routePointHandles.at(handleIndex);
+
+	if (++handleIndex < routePointHandles.size())
+		nextHandle = routePointHandles.at(handleIndex);
+
+	// move origin to the center and scale points if map images have different dimensions
+	QMatrix extraTransformation;
+	extraTransformation.scale(mapImageWidth / quickRouteImageWidth, mapImageHeight / quickRouteImageHeight);
+	extraTransformation.translate(quickRouteImageWidth / -2.0, quickRouteImageHeight / -2.0);
+
+	// transform points using the previous handle
+	// use first handle if no previous handle
+	// do not use the last handle at all (use second to last handle instead for the last points)
+	for (size_t i = 0; i < routePoints.size(); ++i)
+	{
+		if ((double)i > nextHandle.routePointIndex)
+		{
+			if (++handleIndex < routePointHandles.size())
+			{
+				currentHandle = nextHandle;
+				nextHandle = routePointHandles.at(handleIndex);
+			}
+			else
+				nextHandle.routePointIndex = std::numeric_limits<double>::max();
+		}
+
+		QPointF position = projectCoordinate(routePoints.at(i).coordinate, projectionOriginCoordinate);;
+		position = currentHandle.transformation.map(position);
+		routePoints.at(i).position = extraTransformation.map(position);
+	}
+
+	calculateRoutePointValues();
+}
+
+// Both route sources end up here after the points have their coordinates and positions.
+void QuickRouteReader::calculateRoutePointValues()
+{
+	if (routePoints.size() < 2)
+		return;
+
+	// calculate cumulative time, delta times, delta distances, and paces
+	for (size_t i = 1; i < routePoints.size(); ++i)
+	{
+		routePoints.at(i).time = (routePoints.at(i).dateTime.toMSecsSinceEpoch() - routePoints.at(0).dateTime.toMSecsSinceEpoch()) / 1000.0;
+
+		// there is no pace over the gap before a segment
+		if (routePoints.at(i).segmentIndex != routePoints.at(i - 1).segmentIndex)
+			continue;
+
+		double timeToPrevious = (routePoints.at(i).dateTime.toMSecsSinceEpoch() - routePoints.at(i - 1).dateTime.toMSecsSinceEpoch()) / 1000.0;
+		double distanceToPrevious = coordinateDistance(routePoints.at(i - 1).coordinate, routePoints.at(i).coordinate);
+
+		if (distanceToPrevious > 0.0)
+			routePoints.at(i).pace = (timeToPrevious / 60.0) / (distanceToPrevious / 1000.0);
+	}
+
+	double currentAngle = 0.0;
+
+	// calculate orientations
+	for (size_t i = 0; i < routePoints.size() - 1; ++i)
+	{
+		RoutePoint& rp1 = routePoints.at(i);
+		RoutePoint& rp2 = routePoints.at(i + 1);
+
+		QPointF firstToSecond = rp2.position - rp1.position;
+
+		double angle = atan2(-firstToSecond.y(), firstToSecond.x()) * (180.0 / M_PI);
+		angle = 90.0 - angle;
+
+		if (angle > 180.0)
+			angle = angle - 360.0;
+
+		double angleDelta = angle - currentAngle;
+		double finalAngleDelta = angleDelta;
+
+		while (abs(finalAngleDelta) > 360.0)
+			finalAngleDelta += (finalAngleDelta > 0.0) ? -360.0 : 360.0;
+
+		if (abs(finalAngleDelta) > 180.0)
+		{
+			finalAngleDelta = 360.0 - abs(finalAngleDelta);
+			finalAngleDelta *= (angleDelta < 0.0) ? 1.0 : -1.0;
+		}
+
+		currentAngle += finalAngleDelta;
+		rp1.orientation = currentAngle;
+	}
+
+	routePoints.back().orientation = currentAngle;
+}
+
+QPointF QuickRouteReader::projectCoordinate(const QPointF& coordinate, const QPointF& projectionOriginCoordinate)
+{
+	// http://en.wikipedia.org/wiki/Orthographic_projection_%28cartography%29
+	const double R = 6378200.0;
+
+	double lambda0 = projectionOriginCoordinate.x() * M_PI / 180.0;
+	double phi0 = projectionOriginCoordinate.y() * M_PI / 180.0;
+	double lambda = coordinate.x() * M_PI / 180.0;
+	double phi = coordinate.y() * M_PI / 180.0;
+
+	QPointF position;
+
+	position.setX(R * cos(phi) * sin(lambda - lambda0));
+	position.setY(R * (cos(phi0) * sin(phi) - sin(phi0) * cos(phi) * cos(lambda - lambda0)));
+
+	return position;
+}
+
+double QuickRouteReader::coordinateDistance(const QPointF& coordinate1, const QPointF& coordinate2)
+{
+	// http://en.wikipedia.org/wiki/Haversine_formula
+	const double R = 6378200.0;
+
+	double lat1 = coordinate1.y() * M_PI / 180.0;
+	double lat2 = coordinate2.y() * M_PI / 180.0;
+	double deltaLon = (coordinate2.x() - coordinate1.x()) * M_PI / 180.0;
+	double deltaLat = (coordinate2.y() - coordinate1.y()) * M_PI / 180.0;
+
+	double a = pow(sin(deltaLat / 2.0), 2.0) + cos(lat1) * cos(lat2) * pow(sin(deltaLon / 2.0), 2.0);
+	double distance = 2.0 * R * atan2(sqrt(a), sqrt(1.0 - a));
+
+	return distance;
+}
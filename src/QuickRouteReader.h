@@ -1,56 +1,78 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <cstdint>
-
-#include <QFile>
-#include <QMatrix>
-
-#include "RoutePoint.h"
-
-namespace OrientView
-{
-	class MapImageReader;
-	class Settings;
-
-	// Read route point data from QuickRoute JPEG files.
-	class QuickRouteReader
-	{
-
-	public:
-
-		bool initialize(MapImageReader* mapImageReader, Settings* settings);
-
-		const std::vector<RoutePoint>& getRoutePoints() const;
-
-	private:
-
-		bool extractDataPartFromJpeg(QFile& file, QByteArray& buffer);
-		bool readBytes(QFile& file, QByteArray& buffer, int count);
-		void processDataPart(QDataStream& dataStream);
-		void readSession(QDataStream& dataStream, uint32_t length);
-		void readRoute(QDataStream& dataStream);
-		void readHandles(QDataStream& dataStream);
-		double readCoordinate(QDataStream& dataStream);
-		QDateTime readDateTime(QDataStream& dataStream, QDateTime& previous);
-		void processRoutePoints();
-		QPointF projectCoordinate(const QPointF& coordinate, const QPointF& projectionOriginCoordinate);
-		double coordinateDistance(const QPointF& coordinate1, const QPointF& coordinate2);
-
-		struct RoutePointHandle
-		{
-			double routePointIndex = 0.0;
-			QMatrix transformation;
-		};
-
-		double mapImageWidth = 0.0;
-		double mapImageHeight = 0.0;
-		double quickRouteImageWidth = 0.0;
-		double quickRouteImageHeight = 0.0;
-		QPointF projectionOriginCoordinate;
-		std::vector<RoutePoint> routePoints;
-		std::vector<RoutePointHandle> routePointHandles;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QFile>
+#include <QMatrix>
+
+#include "RoutePoint.h"
+#include "RouteTrack.h"
+#include "RouteCache.h"
+
+namespace OrientView
+{
+	class MapImageReader;
+	class ByteReader;
+	class Settings;
+
+	// Read route point data from QuickRoute JPEG files, or from GPX and TCX files with a georeference.
+	class QuickRouteReader
+	{
+
+	public:
+
+		~QuickRouteReader();
+
+		bool initialize(MapImageReader* mapImageReader, Settings* settings);
+
+		const std::vector<RoutePoint>& getRoutePoints() const;
+		int getRunnerCount() const;
+		QuickRouteReader* getRunnerRouteReader(int index) const;
+		bool getCachedRouteTrack(RouteTrack& track) const;
+		void writeRouteCache(const RouteTrack& track);
+
+	private:
+
+		bool readQuickRouteFile(const QString& filePath);
+		bool extractDataPartFromJpeg(const uint8_t* data, size_t size, const uint8_t*& dataPart, size_t& dataPartSize);
+		void processDataPart(ByteReader& byteReader);
+		void readSession(ByteReader& byteReader, uint32_t length);
+		void readRoute(ByteReader& byteReader);
+		void readHandles(ByteReader& byteReader);
+		double readCoordinate(ByteReader& byteReader);
+		QDateTime readDateTime(ByteReader& byteReader, QDateTime& previous);
+		void processRoutePoints();
+		void calculateRoutePointValues();
+		bool readTrackFile(const QString& filePath, const QString& georeferenceText);
+		bool parseGeoreference(const QString& text, QMatrix& georeference);
+		QPointF projectCoordinate(const QPointF& coordinate, const QPointF& projectionOriginCoordinate);
+		double coordinateDistance(const QPointF& coordinate1, const QPointF& coordinate2);
+
+		struct RoutePointHandle
+		{
+			uint32_t segmentIndex = 0;
+			double routePointIndex = 0.0; // inside the segment until the points are processed
+			QMatrix transformation;
+		};
+
+		double mapImageWidth = 0.0;
+		double mapImageHeight = 0.0;
+		double quickRouteImageWidth = 0.0;
+		double quickRouteImageHeight = 0.0;
+		int sampleRate = 1;
+		QPointF projectionOriginCoordinate;
+		std::vector<RoutePoint> routePoints;
+		std::vector<RoutePointHandle> routePointHandles;
+		std::vector<size_t> segmentFirstIndices;
+
+		RouteCache routeCache;
+		RouteTrack cachedRouteTrack;
+		bool isReadFromCache = false;
+
+		std::vector<QuickRouteReader*> runnerRouteReaders; // the routes of the other runners, each read like the default route
+	};
+}
@@ -1,102 +1,121 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include <QElapsedTimer>
-
-#include "RenderOffScreenThread.h"
-#include "MainWindow.h"
-#include "EncodeWindow.h"
-#include "VideoDecoder.h"
-#include "VideoDecoderThread.h"
-#include "VideoStabilizer.h"
-#include "RouteManager.h"
-#include "Renderer.h"
-#include "VideoEncoder.h"
-#include "FrameData.h"
-
-using namespace OrientView;
-
-void RenderOffScreenThread::initialize(MainWindow* mainWindow, EncodeWindow* encodeWindow, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, VideoEncoder* videoEncoder)
-{
-	this->mainWindow = mainWindow;
-	this->encodeWindow = encodeWindow;
-	this->videoDecoder = videoDecoder;
-	this->videoDecoderThread = videoDecoderThread;
-	this->videoStabilizer = videoStabilizer;
-	this->routeManager = routeManager;
-	this->renderer = renderer;
-	this->videoEncoder = videoEncoder;
-
-	frameReadSemaphore = new QSemaphore();
-	frameAvailableSemaphore = new QSemaphore();
-}
-
-RenderOffScreenThread::~RenderOffScreenThread()
-{
-	if (frameAvailableSemaphore != nullptr)
-	{
-		delete frameAvailableSemaphore;
-		frameAvailableSemaphore = nullptr;
-	}
-
-	if (frameReadSemaphore != nullptr)
-	{
-		delete frameReadSemaphore;
-		frameReadSemaphore = nullptr;
-	}
-}
-
-void RenderOffScreenThread::run()
-{
-	FrameData decodedFrameData;
-	FrameData decodedFrameDataGrayscale;
-
-	double frameDuration = videoDecoder->getFrameDuration();
-
-	frameReadSemaphore->release(1);
-
-	while (!isInterruptionRequested())
-	{
-		if (videoDecoderThread->tryGetNextFrame(decodedFrameData, decodedFrameDataGrayscale, 100))
-		{
-			videoStabilizer->processFrame(decodedFrameDataGrayscale);
-			encodeWindow->getContext()->makeCurrent(encodeWindow->getSurface());
-			renderer->startRendering(videoDecoder->getCurrentTime(), frameDuration, videoDecoder->getDecodeDuration(), videoStabilizer->getProcessDuration(), videoEncoder->getEncodeDuration(), 0.0);
-			renderer->uploadFrameData(decodedFrameData);
-			videoDecoderThread->signalFrameRead();
-			renderer->renderAll();
-			renderer->stopRendering();
-			routeManager->update(videoDecoder->getCurrentTime(), frameDuration);
-
-			while (!frameReadSemaphore->tryAcquire(1, 100) && !isInterruptionRequested()) {}
-
-			if (isInterruptionRequested())
-				break;
-
-			renderedFrameData = renderer->getRenderedFrame();
-			renderedFrameData.duration = decodedFrameData.duration;
-			renderedFrameData.cumulativeNumber = decodedFrameData.cumulativeNumber;
-
-			frameAvailableSemaphore->release(1);
-		}
-	}
-
-	encodeWindow->getContext()->doneCurrent();
-	encodeWindow->getContext()->moveToThread(mainWindow->thread());
-}
-
-bool RenderOffScreenThread::tryGetNextFrame(FrameData& frameData, int timeout)
-{
-	if (frameAvailableSemaphore->tryAcquire(1, timeout))
-	{
-		frameData = renderedFrameData;
-		return true;
-	}
-	else
-		return false;
-}
-
-void RenderOffScreenThread::signalFrameRead()
-{
-	frameReadSemaphore->release(1);
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <QElapsedTimer>
+
+#include "RenderOffScreenThread.h"
+#include "VideoDecoder.h"
+#include "VideoDecoderThread.h"
+#include "VideoStabilizer.h"
+#include "RouteManager.h"
+#include "Renderer.h"
+#include "VideoEncoder.h"
+#include "FrameData.h"
+
+using namespace OrientView;
+
+// Queue length above one lets the renderer read back the next frames while the encoder is still converting the previous one.
+void RenderOffScreenThread::initialize(QOpenGLContext* context, QOffscreenSurface* surface, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, VideoEncoder* videoEncoder, int queueLength)
+{
+	this->context = context;
+	this->surface = surface;
+	this->videoDecoder = videoDecoder;
+	this->videoDecoderThread = videoDecoderThread;
+	this->videoStabilizer = videoStabilizer;
+	this->routeManager = routeManager;
+	this->renderer = renderer;
+	this->videoEncoder = videoEncoder;
+
+	renderedFrameQueue = new PipelineSlotQueue<FrameData>();
+	renderedFrameQueue->initialize(queueLength);
+
+	for (FrameData& frameData : renderedFrameQueue->getSlots())
+		frameData.data = new uint8_t[renderer->getRenderedFrameLength()];
+
+	addQueue(videoDecoderThread->getOutputQueue());
+	addQueue(renderedFrameQueue);
+}
+
+RenderOffScreenThread::~RenderOffScreenThread()
+{
+	if (renderedFrameQueue != nullptr)
+	{
+		for (FrameData& frameData : renderedFrameQueue->getSlots())
+			delete[] frameData.data;
+
+		delete renderedFrameQueue;
+		renderedFrameQueue = nullptr;
+	}
+}
+
+void RenderOffScreenThread::run()
+{
+	FrameData decodedFrameData;
+	FrameData decodedFrameDataGrayscale;
+
+	double frameDuration = videoDecoder->getFrameDuration();
+
+	// the decoder runs ahead of the renderer, so the times come with the frames
+	while (videoDecoderThread->tryGetNextFrame(decodedFrameData, decodedFrameDataGrayscale, -1))
+	{
+		videoStabilizer->processFrame(decodedFrameDataGrayscale);
+
+		if (context != nullptr)
+			context->makeCurrent(surface);
+
+		renderer->startRendering(decodedFrameData.time, frameDuration, decodedFrameData.decodeDuration, videoStabilizer->getProcessDuration(), videoEncoder->getEncodeDuration(), 0.0);
+		renderer->uploadFrameData(decodedFrameData);
+		videoDecoderThread->signalFrameRead();
+		renderer->renderAll();
+		renderer->stopRendering();
+		routeManager->update(decodedFrameData.time, frameDuration);
+
+		FrameData* renderedFrameData = renderedFrameQueue->acquire();
+
+		if (renderedFrameData == nullptr)
+			break;
+
+		renderer->getRenderedFrame(*renderedFrameData);
+		renderedFrameData->duration = decodedFrameData.duration;
+		renderedFrameData->timeStamp = decodedFrameData.timeStamp;
+		renderedFrameData->time = decodedFrameData.time;
+		renderedFrameData->cumulativeNumber = decodedFrameData.cumulativeNumber;
+		renderedFrameData->decodeDuration = decodedFrameData.decodeDuration;
+		renderedFrameData->stabilizeDuration = videoStabilizer->getProcessDuration();
+		renderedFrameData->renderDuration = renderer->getRenderDuration();
+
+		renderedFrameQueue->push();
+	}
+
+	renderedFrameQueue->finish();
+
+	// the thread object itself lives in the thread that created it and gave the context
+	if (context != nullptr)
+	{
+		context->doneCurrent();
+		context->moveToThread(thread());
+	}
+}
+
+// The frame data stays valid until signalFrameRead is called. A negative timeout blocks.
+bool RenderOffScreenThread::tryGetNextFrame(FrameData& frameData, int timeout)
+{
+	FrameData* renderedFrameData = renderedFrameQueue->tryPop(timeout);
+
+	if (renderedFrameData == nullptr)
+		return false;
+
+	frameData = *renderedFrameData;
+
+	return true;
+}
+
+void RenderOffScreenThread::signalFrameRead()
+{
+	renderedFrameQueue->release();
+}
+
+PipelineSlotQueue<FrameData>* RenderOffScreenThread::getOutputQueue()
+{
+	return renderedFrameQueue;
+}
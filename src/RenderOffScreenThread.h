@@ -1,55 +1,54 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QThread>
-#include <QSemaphore>
-
-#include "FrameData.h"
-
-namespace OrientView
-{
-	class MainWindow;
-	class EncodeWindow;
-	class VideoDecoder;
-	class VideoDecoderThread;
-	class VideoStabilizer;
-	class RouteManager;
-	class Renderer;
-	class VideoEncoder;
-
-	// Run renderer on a thread and draw to hidden framebuffers.
-	class RenderOffScreenThread : public QThread
-	{
-		Q_OBJECT
-
-	public:
-
-		void initialize(MainWindow* mainWindow, EncodeWindow* encodeWindow, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, VideoEncoder* videoEncoder);
-		~RenderOffScreenThread();
-
-		bool tryGetNextFrame(FrameData& frameData, int timeout);
-		void signalFrameRead();
-
-	protected:
-
-		void run();
-
-	private:
-
-		MainWindow* mainWindow = nullptr;
-		EncodeWindow* encodeWindow = nullptr;
-		VideoDecoder* videoDecoder = nullptr;
-		VideoDecoderThread* videoDecoderThread = nullptr;
-		VideoStabilizer* videoStabilizer = nullptr;
-		RouteManager* routeManager = nullptr;
-		Renderer* renderer = nullptr;
-		VideoEncoder* videoEncoder = nullptr;
-
-		QSemaphore* frameReadSemaphore = nullptr;
-		QSemaphore* frameAvailableSemaphore = nullptr;
-
-		FrameData renderedFrameData;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+
+#include "PipelineStage.h"
+#include "PipelineQueue.h"
+#include "FrameData.h"
+
+namespace OrientView
+{
+	class VideoDecoder;
+	class VideoDecoderThread;
+	class VideoStabilizer;
+	class RouteManager;
+	class Renderer;
+	class VideoEncoder;
+
+	// Run renderer on a thread and draw to hidden framebuffers.
+	class RenderOffScreenThread : public PipelineStage
+	{
+		Q_OBJECT
+
+	public:
+
+		void initialize(QOpenGLContext* context, QOffscreenSurface* surface, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, VideoEncoder* videoEncoder, int queueLength);
+		~RenderOffScreenThread();
+
+		bool tryGetNextFrame(FrameData& frameData, int timeout);
+		void signalFrameRead();
+
+		PipelineSlotQueue<FrameData>* getOutputQueue();
+
+	protected:
+
+		void run();
+
+	private:
+
+		QOpenGLContext* context = nullptr;
+		QOffscreenSurface* surface = nullptr;
+		VideoDecoder* videoDecoder = nullptr;
+		VideoDecoderThread* videoDecoderThread = nullptr;
+		VideoStabilizer* videoStabilizer = nullptr;
+		RouteManager* routeManager = nullptr;
+		Renderer* renderer = nullptr;
+		VideoEncoder* videoEncoder = nullptr;
+
+		PipelineSlotQueue<FrameData>* renderedFrameQueue = nullptr;
+	};
+}
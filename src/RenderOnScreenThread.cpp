@@ -1,141 +1,186 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include <QElapsedTimer>
-
-#include "RenderOnScreenThread.h"
-#include "MainWindow.h"
-#include "VideoWindow.h"
-#include "VideoDecoder.h"
-#include "VideoDecoderThread.h"
-#include "VideoStabilizer.h"
-#include "RouteManager.h"
-#include "Renderer.h"
-#include "InputHandler.h"
-#include "Settings.h"
-
-using namespace OrientView;
-
-void RenderOnScreenThread::initialize(MainWindow* mainWindow, VideoWindow* videoWindow, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, InputHandler* inputHandler)
-{
-	this->mainWindow = mainWindow;
-	this->videoWindow = videoWindow;
-	this->videoDecoder = videoDecoder;
-	this->videoDecoderThread = videoDecoderThread;
-	this->videoStabilizer = videoStabilizer;
-	this->routeManager = routeManager;
-	this->renderer = renderer;
-	this->inputHandler = inputHandler;
-}
-
-void RenderOnScreenThread::run()
-{
-	FrameData frameData;
-	FrameData frameDataGrayscale;
-
-	QElapsedTimer frameDurationTimer;
-	double frameDuration = 30.0;
-	double spareTime = 15.0;
-
-	frameDurationTimer.start();
-
-	while (!isInterruptionRequested())
-	{
-		if (!videoWindow->isExposed())
-		{
-			QThread::msleep(100);
-			continue;
-		}
-
-		bool gotFrame = false;
-
-		if (!isPaused || shouldAdvanceOneFrame)
-		{
-			gotFrame = videoDecoderThread->tryGetNextFrame(frameData, frameDataGrayscale, 0);
-			shouldAdvanceOneFrame = false;
-		}
-
-		if (gotFrame)
-			videoStabilizer->processFrame(frameDataGrayscale);
-
-		videoWindow->getContext()->makeCurrent(videoWindow);
-		renderer->startRendering(videoDecoder->getCurrentTime(), frameDuration, videoDecoder->getDecodeDuration(), videoStabilizer->getProcessDuration(), 0.0, spareTime);
-
-		videoDecoder->resetDecodeDuration();
-		videoStabilizer->resetProcessDuration();
-
-		if (gotFrame)
-		{
-			renderer->uploadFrameData(frameData);
-			videoDecoderThread->signalFrameRead();
-		}
-
-		renderer->renderAll();
-		renderer->stopRendering();
-
-		routeManager->update(videoDecoder->getCurrentTime(), frameDuration);
-		inputHandler->handleInput(frameDuration);
-
-		if (windowHasBeenResized)
-		{
-			renderer->windowResized(windowWidth, windowHeight);
-			routeManager->windowResized(windowWidth, windowHeight);
-			windowHasBeenResized = false;
-		}
-
-		videoWindow->getContext()->swapBuffers(videoWindow);
-
-		if (gotFrame)
-		{
-			spareTime = (frameData.duration - (frameDurationTimer.nsecsElapsed() / 1000.0)) / 1000.0;
-
-			// use combination of normal and spinning wait to sync the frame rate accurately
-			while (true)
-			{
-				int64_t timeToSleep = frameData.duration - (frameDurationTimer.nsecsElapsed() / 1000);
-
-				if (timeToSleep > 2000)
-				{
-					QThread::msleep(1);
-					continue;
-				}
-				else if (timeToSleep > 0)
-					continue;
-				else
-					break;
-			}
-		}
-		else
-			spareTime = 0.0;
-
-		frameDuration = frameDurationTimer.nsecsElapsed() / 1000000.0;
-		frameDurationTimer.restart();
-	}
-
-	videoWindow->getContext()->doneCurrent();
-	videoWindow->getContext()->moveToThread(mainWindow->thread());
-}
-
-bool RenderOnScreenThread::getIsPaused()
-{
-	return isPaused;
-}
-
-void RenderOnScreenThread::togglePaused()
-{
-	isPaused = !isPaused;
-	shouldAdvanceOneFrame = false;
-}
-
-void RenderOnScreenThread::advanceOneFrame()
-{
-	shouldAdvanceOneFrame = true;
-}
-
-void RenderOnScreenThread::windowResized(int newWidth, int newHeight)
-{
-	windowWidth = newWidth;
-	windowHeight = newHeight;
-
-	windowHasBeenResized = true;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <QElapsedTimer>
+#include <QScreen>
+
+#include "RenderOnScreenThread.h"
+#include "MainWindow.h"
+#include "VideoWindow.h"
+#include "VideoDecoder.h"
+#include "VideoDecoderThread.h"
+#include "VideoStabilizer.h"
+#include "RouteManager.h"
+#include "Renderer.h"
+#include "InputHandler.h"
+#include "Settings.h"
+
+using namespace OrientView;
+
+void RenderOnScreenThread::initialize(MainWindow* mainWindow, VideoWindow* videoWindow, VideoDecoder* videoDecoder, VideoDecoderThread* videoDecoderThread, VideoStabilizer* videoStabilizer, RouteManager* routeManager, Renderer* renderer, InputHandler* inputHandler, Settings* settings)
+{
+	this->mainWindow = mainWindow;
+	this->videoWindow = videoWindow;
+	this->videoDecoder = videoDecoder;
+	this->videoDecoderThread = videoDecoderThread;
+	this->videoStabilizer = videoStabilizer;
+	this->routeManager = routeManager;
+	this->renderer = renderer;
+	this->inputHandler = inputHandler;
+	this->settings = settings;
+}
+
+void RenderOnScreenThread::run()
+{
+	FrameData frameData;
+	FrameData frameDataGrayscale;
+
+	QElapsedTimer frameDurationTimer;
+	double frameDuration = 30.0;
+	double spareTime = 15.0;
+
+	// the time of the frame on the screen, the decoder can already be further
+	double currentTime = videoDecoder->getCurrentTime();
+
+	frameDurationTimer.start();
+	framePacer.initialize(settings, videoWindow->screen()->refreshRate());
+
+	while (!isInterruptionRequested())
+	{
+		if (!videoWindow->isExposed())
+		{
+			QThread::msleep(100);
+			continue;
+		}
+
+		bool gotFrame = false;
+		bool waitingForFrame = !isPaused || shouldAdvanceOneFrame;
+
+		if (waitingForFrame)
+			gotFrame = videoDecoderThread->tryGetNextFrame(frameData, frameDataGrayscale, 0);
+
+		// nothing would change on the screen, so block until a new frame arrives or something else happens
+		if (!gotFrame && !isRenderNeeded())
+		{
+			if (waitingForFrame)
+				gotFrame = videoDecoderThread->tryGetNextFrame(frameData, frameDataGrayscale, 10);
+			else
+				waitForRenderRequest(100);
+
+			if (!gotFrame)
+			{
+				framePacer.reset();
+
+				// the idle time should not show up as a long frame to the input handling
+				frameDurationTimer.restart();
+				continue;
+			}
+		}
+
+		if (gotFrame)
+		{
+			shouldAdvanceOneFrame = false;
+			currentTime = frameData.time;
+			videoStabilizer->processFrame(frameDataGrayscale);
+		}
+
+		videoWindow->getContext()->makeCurrent(videoWindow);
+		renderer->startRendering(currentTime, frameDuration, videoDecoder->getDecodeDuration(), videoStabilizer->getProcessDuration(), 0.0, spareTime);
+		renderer->setFramePacingStatistics(framePacer.getAverageDrift(), framePacer.getMissedFrameCount(), framePacer.getResynchronizationCount());
+
+		videoDecoder->resetDecodeDuration();
+		videoStabilizer->resetProcessDuration();
+
+		if (gotFrame)
+		{
+			renderer->uploadFrameData(frameData);
+			videoDecoderThread->signalFrameRead();
+		}
+
+		renderer->renderAll();
+		renderer->stopRendering();
+
+		routeManager->update(currentTime, frameDuration);
+		inputHandler->handleInput(frameDuration);
+
+		if (windowHasBeenResized)
+		{
+			renderer->windowResized(windowWidth, windowHeight);
+			routeManager->windowResized(windowWidth, windowHeight);
+			windowHasBeenResized = false;
+		}
+
+		// paused frames and single steps are shown immediately, playback follows the video clock
+		if (gotFrame && !isPaused)
+			spareTime = framePacer.waitForPresentation(frameData.duration);
+		else
+		{
+			framePacer.reset();
+			spareTime = 0.0;
+		}
+
+		videoWindow->getContext()->swapBuffers(videoWindow);
+
+		if (gotFrame && !isPaused)
+			framePacer.framePresented();
+
+		frameDuration = frameDurationTimer.nsecsElapsed() / 1000000.0;
+		frameDurationTimer.restart();
+	}
+
+	framePacer.logStatistics();
+
+	videoWindow->getContext()->doneCurrent();
+	videoWindow->getContext()->moveToThread(mainWindow->thread());
+}
+
+bool RenderOnScreenThread::getIsPaused()
+{
+	return isPaused;
+}
+
+void RenderOnScreenThread::togglePaused()
+{
+	isPaused = !isPaused;
+	shouldAdvanceOneFrame = false;
+}
+
+void RenderOnScreenThread::advanceOneFrame()
+{
+	shouldAdvanceOneFrame = true;
+}
+
+void RenderOnScreenThread::windowResized(int newWidth, int newHeight)
+{
+	windowWidth = newWidth;
+	windowHeight = newHeight;
+
+	windowHasBeenResized = true;
+	requestRender();
+}
+
+void RenderOnScreenThread::requestRender()
+{
+	QMutexLocker locker(&renderRequestMutex);
+
+	renderRequested = true;
+	renderRequestCondition.wakeAll();
+}
+
+bool RenderOnScreenThread::isRenderNeeded()
+{
+	renderRequestMutex.lock();
+	bool wasRequested = renderRequested;
+	renderRequested = false;
+	renderRequestMutex.unlock();
+
+	return wasRequested || windowHasBeenResized || renderer->getIsDirty() || routeManager->getIsDirty() || inputHandler->getIsDirty();
+}
+
+void RenderOnScreenThread::waitForRenderRequest(int timeout)
+{
+	QMutexLocker locker(&renderRequestMutex);
+
+	if (!renderRequested)
+		renderRequestCondition.wait(&renderRequestMutex, timeout);
+}
@@ -1,736 +1,1672 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include <QOpenGLPixelTransferOptions>
-
-#include "Renderer.h"
-#include "VideoDecoder.h"
-#include "MapImageReader.h"
-#include "VideoStabilizer.h"
-#include "InputHandler.h"
-#include "RouteManager.h"
-#include "Settings.h"
-#include "FrameData.h"
-
-using namespace OrientView;
-
-Panel::Panel() : texture(QOpenGLTexture::Target2D)
-{
-}
-
-bool Renderer::initialize(VideoDecoder* videoDecoder, MapImageReader* mapImageReader, VideoStabilizer* videoStabilizer, InputHandler* inputHandler, RouteManager* routeManager, Settings* settings, bool renderToOffscreen)
-{
-	qDebug("Initializing renderer");
-
-	this->videoStabilizer = videoStabilizer;
-	this->inputHandler = inputHandler;
-	this->routeManager = routeManager;
-	this->renderToOffscreen = renderToOffscreen;
-
-	videoPanel.clearColor = settings->video.backgroundColor;
-	videoPanel.clippingEnabled = settings->video.enableClipping;
-	videoPanel.clearingEnabled = settings->video.enableClearing;
-	videoPanel.userX = settings->video.x;
-	videoPanel.userY = settings->video.y;
-	videoPanel.userAngle = settings->video.angle;
-	videoPanel.userScale = settings->video.scale;
-	videoPanel.textureWidth = videoDecoder->getFrameWidth();
-	videoPanel.textureHeight = videoDecoder->getFrameHeight();
-	videoPanel.texelWidth = 1.0 / videoPanel.textureWidth;
-	videoPanel.texelHeight = 1.0 / videoPanel.textureHeight;
-
-	mapPanel.clearColor = settings->map.backgroundColor;
-	mapPanel.userX = settings->map.x;
-	mapPanel.userY = settings->map.y;
-	mapPanel.userAngle = settings->map.angle;
-	mapPanel.userScale = settings->map.scale;
-	mapPanel.textureWidth = mapImageReader->getMapImage().width();
-	mapPanel.textureHeight = mapImageReader->getMapImage().height();
-	mapPanel.texelWidth = 1.0 / mapPanel.textureWidth;
-	mapPanel.texelHeight = 1.0 / mapPanel.textureHeight;
-	mapPanel.relativeWidth = settings->map.relativeWidth;
-
-	multisamples = settings->window.multisamples;
-	renderMode = settings->renderer.renderMode;
-	showInfoPanel = settings->renderer.showInfoPanel;
-	infoPanelFontSize = settings->renderer.infoPanelFontSize;
-
-	const double averagingFactor = 0.005;
-	averageFps.setAlpha(averagingFactor);
-	averageFrameDuration.setAlpha(averagingFactor);
-	averageDecodeDuration.setAlpha(averagingFactor);
-	averageStabilizeDuration.setAlpha(averagingFactor);
-	averageRenderDuration.setAlpha(averagingFactor);
-	averageEncodeDuration.setAlpha(averagingFactor);
-	averageSpareTime.setAlpha(averagingFactor);
-
-	initializeOpenGLFunctions();
-
-	if (!windowResized(settings->window.width, settings->window.height))
-		return false;
-
-	// 1 2
-	// 4 3
-	GLfloat videoPanelBuffer[] =
-	{
-		-(float)videoPanel.textureWidth / 2, (float)videoPanel.textureHeight / 2, 0.0f, // 1
-		(float)videoPanel.textureWidth / 2, (float)videoPanel.textureHeight / 2, 0.0f, // 2
-		(float)videoPanel.textureWidth / 2, -(float)videoPanel.textureHeight / 2, 0.0f, // 3
-		-(float)videoPanel.textureWidth / 2, -(float)videoPanel.textureHeight / 2, 0.0f, // 4
-
-		0.0f, 0.0f, // 1
-		1.0f, 0.0f, // 2
-		1.0f, 1.0f, // 3
-		0.0f, 1.0f  // 4
-	};
-
-	// 1 2
-	// 4 3
-	GLfloat mapPanelBuffer[] =
-	{
-		-(float)mapPanel.textureWidth / 2, (float)mapPanel.textureHeight / 2, 0.0f, // 1
-		(float)mapPanel.textureWidth / 2, (float)mapPanel.textureHeight / 2, 0.0f, // 2
-		(float)mapPanel.textureWidth / 2, -(float)mapPanel.textureHeight / 2, 0.0f, // 3
-		-(float)mapPanel.textureWidth / 2, -(float)mapPanel.textureHeight / 2, 0.0f, // 4
-
-		0.0f, 0.0f, // 1
-		1.0f, 0.0f, // 2
-		1.0f, 1.0f, // 3
-		0.0f, 1.0f  // 4
-	};
-
-	videoPanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-	videoPanel.vertexBuffer.create();
-	videoPanel.vertexBuffer.bind();
-	videoPanel.vertexBuffer.allocate(videoPanelBuffer, sizeof(GLfloat) * 20);
-	videoPanel.vertexBuffer.release();
-
-	mapPanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
-	mapPanel.vertexBuffer.create();
-	mapPanel.vertexBuffer.bind();
-	mapPanel.vertexBuffer.allocate(mapPanelBuffer, sizeof(GLfloat) * 20);
-	mapPanel.vertexBuffer.release();
-
-	videoPanel.texture.create();
-	videoPanel.texture.bind();
-	videoPanel.texture.setSize(videoPanel.textureWidth, videoPanel.textureHeight);
-	videoPanel.texture.setFormat(QOpenGLTexture::RGBA8_UNorm);
-	videoPanel.texture.setMinificationFilter(QOpenGLTexture::Linear);
-	videoPanel.texture.setMagnificationFilter(QOpenGLTexture::Linear);
-	videoPanel.texture.setWrapMode(QOpenGLTexture::ClampToEdge);
-	videoPanel.texture.allocateStorage();
-	videoPanel.texture.release();
-
-	mapPanel.texture.create();
-	mapPanel.texture.bind();
-	mapPanel.texture.setData(mapImageReader->getMapImage());
-	mapPanel.texture.setMinificationFilter(QOpenGLTexture::Linear);
-	mapPanel.texture.setMagnificationFilter(QOpenGLTexture::Linear);
-	mapPanel.texture.setWrapMode(QOpenGLTexture::ClampToEdge);
-	mapPanel.texture.release();
-
-	if (!loadRescaleShader(videoPanel, settings->video.rescaleShader))
-		return false;
-
-	if (!loadRescaleShader(mapPanel, settings->map.rescaleShader))
-		return false;
-
-	paintDevice = new QOpenGLPaintDevice(windowWidth, windowHeight);
-	paintDevice->setPaintFlipped(renderToOffscreen);
-	painter = new QPainter();
-
-	return true;
-}
-
-bool Renderer::windowResized(int newWidth, int newHeight)
-{
-	windowWidth = newWidth;
-	windowHeight = newHeight;
-
-	fullClearRequested = true;
-
-	if (renderToOffscreen)
-	{
-		QOpenGLFramebufferObjectFormat format;
-		format.setSamples(multisamples);
-		format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-
-		if (offscreenFramebuffer != nullptr)
-		{
-			delete offscreenFramebuffer;
-			offscreenFramebuffer = nullptr;
-		}
-
-		offscreenFramebuffer = new QOpenGLFramebufferObject(windowWidth, windowHeight, format);
-
-		if (!offscreenFramebuffer->isValid())
-		{
-			qWarning("Could not create main frame buffer");
-			return false;
-		}
-
-		format.setSamples(0);
-
-		if (offscreenFramebufferNonMultisample != nullptr)
-		{
-			delete offscreenFramebufferNonMultisample;
-			offscreenFramebufferNonMultisample = nullptr;
-		}
-
-		offscreenFramebufferNonMultisample = new QOpenGLFramebufferObject(windowWidth, windowHeight, format);
-
-		if (!offscreenFramebufferNonMultisample->isValid())
-		{
-			qWarning("Could not create non multisampled main frame buffer");
-			return false;
-		}
-
-		if (renderedFrameData.data != nullptr)
-		{
-			delete renderedFrameData.data;
-			renderedFrameData.data = nullptr;
-		}
-
-		renderedFrameData = FrameData();
-		renderedFrameData.dataLength = (size_t)(windowWidth * windowHeight * 4);
-		renderedFrameData.rowLength = (size_t)(windowWidth * 4);
-		renderedFrameData.data = new uint8_t[renderedFrameData.dataLength];
-		renderedFrameData.width = windowWidth;
-		renderedFrameData.height = windowHeight;
-	}
-
-	return true;
-}
-
-Renderer::~Renderer()
-{
-	if (renderedFrameData.data != nullptr)
-	{
-		delete renderedFrameData.data;
-		renderedFrameData.data = nullptr;
-	}
-
-	if (offscreenFramebufferNonMultisample != nullptr)
-	{
-		delete offscreenFramebufferNonMultisample;
-		offscreenFramebufferNonMultisample = nullptr;
-	}
-
-	if (offscreenFramebuffer != nullptr)
-	{
-		delete offscreenFramebuffer;
-		offscreenFramebuffer = nullptr;
-	}
-
-	if (painter != nullptr)
-	{
-		delete painter;
-		painter = nullptr;
-	}
-
-	if (paintDevice != nullptr)
-	{
-		delete paintDevice;
-		paintDevice = nullptr;
-	}
-}
-
-bool Renderer::loadRescaleShader(Panel& panel, const QString& shaderName)
-{
-	if (!panel.shaderProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, QString("data/shaders/rescale_%1.vert").arg(shaderName)))
-		return false;
-
-	if (!panel.shaderProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, QString("data/shaders/rescale_%1.frag").arg(shaderName)))
-		return false;
-
-	if (!panel.shaderProgram.link())
-		return false;
-
-	panel.vertexArrayObject.create();
-	panel.vertexArrayObject.bind();
-
-	panel.vertexBuffer.bind();
-	panel.shaderProgram.enableAttributeArray("vertexPosition");
-	panel.shaderProgram.enableAttributeArray("vertexTextureCoordinate");
-	panel.shaderProgram.setAttributeBuffer("vertexPosition", GL_FLOAT, 0, 3, 0);
-	panel.shaderProgram.setAttributeBuffer("vertexTextureCoordinate", GL_FLOAT, sizeof(GLfloat) * 12, 2, 0);
-
-	panel.vertexArrayObject.release();
-	panel.vertexBuffer.release();
-
-	return true;
-}
-
-void Renderer::startRendering(double currentTime, double frameDuration, double decodeDuration, double stabilizeDuration, double encodeDuration, double spareTime)
-{
-	renderDurationTimer.restart();
-
-	this->currentTime = currentTime;
-
-	averageFps.addMeasurement(1000.0 / frameDuration, frameDuration);
-	averageFrameDuration.addMeasurement(frameDuration, frameDuration);
-	averageDecodeDuration.addMeasurement(decodeDuration, frameDuration);
-	averageStabilizeDuration.addMeasurement(stabilizeDuration, frameDuration);
-	averageRenderDuration.addMeasurement(renderDuration, frameDuration);
-	averageEncodeDuration.addMeasurement(encodeDuration, frameDuration);
-	averageSpareTime.addMeasurement(spareTime, frameDuration);
-
-	paintDevice->setSize(QSize(windowWidth, windowHeight));
-
-	glViewport(0, 0, windowWidth, windowHeight);
-	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-	glDisable(GL_DEPTH_TEST);
-}
-
-void Renderer::uploadFrameData(const FrameData& frameData)
-{
-	if (frameData.data != nullptr && frameData.width > 0 && frameData.height > 0)
-	{
-		QOpenGLPixelTransferOptions options;
-
-		options.setRowLength((int)(frameData.rowLength / 4));
-		options.setImageHeight(frameData.height);
-		options.setAlignment(1);
-
-		videoPanel.texture.setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, frameData.data, &options);
-	}
-}
-
-void Renderer::renderAll()
-{
-	if (renderToOffscreen)
-		offscreenFramebuffer->bind();
-
-	if (renderMode == RenderMode::All || renderMode == RenderMode::Video)
-		renderVideoPanel();
-
-	if (renderMode == RenderMode::All || renderMode == RenderMode::Map)
-	{
-		renderMapPanel();
-		renderRoute(routeManager->getDefaultRoute());
-
-		if (mapPanel.clippingEnabled)
-		{
-			int mapRightBorderX = (int)(mapPanel.relativeWidth * windowWidth + 0.5);
-
-			painter->begin(paintDevice);
-			painter->setPen(QColor(0, 0, 0));
-			painter->drawLine(mapRightBorderX, 0, mapRightBorderX, (int)windowHeight);
-			painter->end();
-		}
-	}
-
-	if (showInfoPanel)
-		renderInfoPanel();
-
-	if (renderToOffscreen)
-		offscreenFramebuffer->release();
-}
-
-void Renderer::stopRendering()
-{
-	renderDuration = renderDurationTimer.nsecsElapsed() / 1000000.0;
-}
-
-FrameData Renderer::getRenderedFrame()
-{
-	if (!renderToOffscreen)
-		return FrameData();
-
-	QOpenGLFramebufferObject* sourceFbo = offscreenFramebuffer;
-
-	// pixels cannot be directly read from a multisampled framebuffer
-	// copy the framebuffer to a non-multisampled framebuffer and continue
-	if (sourceFbo->format().samples() != 0)
-	{
-		QRect rect(0, 0, windowWidth, windowHeight);
-		QOpenGLFramebufferObject::blitFramebuffer(offscreenFramebufferNonMultisample, rect, sourceFbo, rect);
-		sourceFbo = offscreenFramebufferNonMultisample;
-	}
-
-	sourceFbo->bind();
-	glReadPixels(0, 0, windowWidth, windowHeight, GL_RGBA, GL_UNSIGNED_BYTE, renderedFrameData.data);
-	sourceFbo->release();
-
-	return renderedFrameData;
-}
-
-void Renderer::renderVideoPanel()
-{
-	videoPanel.vertexMatrix.setToIdentity();
-
-	if (!renderToOffscreen)
-		videoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, -windowHeight / 2, windowHeight / 2, 0.0f, 1.0f);
-	else
-		videoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, windowHeight / 2, -windowHeight / 2, 0.0f, 1.0f);
-
-	if (renderMode != RenderMode::Video)
-	{
-		videoPanel.offsetX = (windowWidth / 2.0) - (((1.0 - mapPanel.relativeWidth) * windowWidth) / 2.0);
-		videoPanel.scale = ((1.0 - mapPanel.relativeWidth) * windowWidth) / videoPanel.textureWidth;
-	}
-	else
-	{
-		videoPanel.offsetX = 0.0;
-		videoPanel.scale = windowWidth / videoPanel.textureWidth;
-	}
-
-	if (videoPanel.scale * videoPanel.textureHeight > windowHeight)
-		videoPanel.scale = windowHeight / videoPanel.textureHeight;
-
-	videoPanel.vertexMatrix.translate(videoPanel.offsetX, videoPanel.offsetY); // window coordinate units
-	videoPanel.vertexMatrix.translate( // scaled map pixel units
-		videoPanel.x + videoPanel.userX + videoStabilizer->getX() * videoPanel.textureWidth * videoPanel.scale * videoPanel.userScale,
-		videoPanel.y + videoPanel.userY - videoStabilizer->getY() * videoPanel.textureHeight * videoPanel.scale * videoPanel.userScale);
-	videoPanel.vertexMatrix.rotate(videoPanel.angle + videoPanel.userAngle - videoStabilizer->getAngle(), 0.0f, 0.0f, 1.0f);
-	videoPanel.vertexMatrix.scale(videoPanel.scale * videoPanel.userScale);
-
-	if (fullClearRequested)
-	{
-		glClearColor(videoPanel.clearColor.redF(), videoPanel.clearColor.greenF(), videoPanel.clearColor.blueF(), 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-		fullClearRequested = false;
-	}
-
-	if (videoPanel.clippingEnabled)
-	{
-		double videoPanelWidth = videoPanel.scale * videoPanel.userScale * videoPanel.textureWidth;
-		double videoPanelHeight = videoPanel.scale * videoPanel.userScale * videoPanel.textureHeight;
-		double leftMargin = (windowWidth - videoPanelWidth) / 2.0;
-		double bottomMargin = (windowHeight - videoPanelHeight) / 2.0;
-
-		glEnable(GL_SCISSOR_TEST);
-
-		glScissor((int)(leftMargin + videoPanel.x + videoPanel.userX + videoPanel.offsetX + 0.5),
-			(int)(bottomMargin + videoPanel.y + videoPanel.userY + videoPanel.offsetY + 0.5),
-			(int)(videoPanelWidth + 0.5),
-			(int)(videoPanelHeight + 0.5));
-	}
-
-	if (videoPanel.clearingEnabled)
-	{
-		glClearColor(videoPanel.clearColor.redF(), videoPanel.clearColor.greenF(), videoPanel.clearColor.blueF(), 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-	}
-
-	renderPanel(videoPanel);
-	glDisable(GL_SCISSOR_TEST);
-}
-
-void Renderer::renderMapPanel()
-{
-	mapPanel.vertexMatrix.setToIdentity();
-
-	if (!renderToOffscreen)
-		mapPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, -windowHeight / 2, windowHeight / 2, 0.0f, 1.0f);
-	else
-		mapPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, windowHeight / 2, -windowHeight / 2, 0.0f, 1.0f);
-
-	if (renderMode != RenderMode::Map)
-		mapPanel.offsetX = -((windowWidth / 2.0) - ((mapPanel.relativeWidth * windowWidth) / 2.0));
-	else
-		mapPanel.offsetX = 0.0;
-
-	mapPanel.vertexMatrix.translate(mapPanel.offsetX, mapPanel.offsetY); // window coordinate units
-	mapPanel.vertexMatrix.rotate(mapPanel.angle + mapPanel.userAngle + routeManager->getAngle(), 0.0f, 0.0f, 1.0f);
-	mapPanel.vertexMatrix.scale(mapPanel.scale * mapPanel.userScale * routeManager->getScale());
-	mapPanel.vertexMatrix.translate(mapPanel.x + mapPanel.userX + routeManager->getX(), mapPanel.y + mapPanel.userY + routeManager->getY()); // map pixel units
-
-	mapPanel.clippingEnabled = (renderMode == RenderMode::All);
-
-	if (fullClearRequested)
-	{
-		glClearColor(mapPanel.clearColor.redF(), mapPanel.clearColor.greenF(), mapPanel.clearColor.blueF(), 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-		fullClearRequested = false;
-	}
-
-	if (mapPanel.clippingEnabled)
-	{
-		glEnable(GL_SCISSOR_TEST);
-		glScissor(0, 0, (int)(mapPanel.relativeWidth * windowWidth + 0.5), (int)windowHeight);
-	}
-
-	if (mapPanel.clearingEnabled)
-	{
-		glClearColor(mapPanel.clearColor.redF(), mapPanel.clearColor.greenF(), mapPanel.clearColor.blueF(), 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-	}
-
-	renderPanel(mapPanel);
-	glDisable(GL_SCISSOR_TEST);
-}
-
-void Renderer::renderPanel(Panel& panel)
-{
-	panel.shaderProgram.bind();
-
-	panel.shaderProgram.setUniformValue("vertexMatrix", panel.vertexMatrix);
-	panel.shaderProgram.setUniformValue("textureSampler", 0);
-	panel.shaderProgram.setUniformValue("textureWidth", (float)panel.textureWidth);
-	panel.shaderProgram.setUniformValue("textureHeight", (float)panel.textureHeight);
-	panel.shaderProgram.setUniformValue("texelWidth", (float)panel.texelWidth);
-	panel.shaderProgram.setUniformValue("texelHeight", (float)panel.texelHeight);
-
-	panel.vertexArrayObject.bind();
-	panel.texture.bind();
-
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-	panel.texture.release();
-	panel.vertexArrayObject.release();
-	panel.shaderProgram.release();
-}
-
-void Renderer::renderRoute(Route& route)
-{
-	QMatrix painterMatrix;
-	painterMatrix.translate(windowWidth / 2.0, windowHeight / 2.0);
-	painterMatrix.translate(mapPanel.offsetX, mapPanel.offsetY);
-	painterMatrix.rotate(-(mapPanel.angle + mapPanel.userAngle + routeManager->getAngle()));
-	painterMatrix.scale(mapPanel.scale * mapPanel.userScale * routeManager->getScale(), mapPanel.scale * mapPanel.userScale * routeManager->getScale());
-	painterMatrix.translate(mapPanel.x + mapPanel.userX + routeManager->getX(), -(mapPanel.y + mapPanel.userY + routeManager->getY()));
-
-	painter->begin(paintDevice);
-	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform | QPainter::HighQualityAntialiasing);
-
-	if (renderMode != RenderMode::Map)
-	{
-		painter->setClipping(true);
-		painter->setClipRect(0, 0, (int)(mapPanel.relativeWidth * windowWidth + 0.5), (int)windowHeight);
-	}
-
-	painter->setWorldMatrix(painterMatrix);
-
-	if (route.routeRenderMode == RouteRenderMode::Discreet || route.routeRenderMode == RouteRenderMode::Highlight)
-	{
-		QPen routePen;
-		routePen.setWidthF(route.routeWidth * route.userScale);
-		routePen.setJoinStyle(Qt::PenJoinStyle::RoundJoin);
-		routePen.setCapStyle(Qt::PenCapStyle::RoundCap);
-		routePen.setColor(route.routeRenderMode == RouteRenderMode::Discreet ? route.discreetColor : route.highlightColor);
-
-		painter->setPen(routePen);
-		painter->setBrush(Qt::NoBrush);
-		painter->drawPath(route.routePath);
-	}
-
-	if (route.routeRenderMode == RouteRenderMode::Pace)
-	{
-		QPen paceRoutePen;
-		paceRoutePen.setWidthF(route.routeWidth * route.userScale);
-		paceRoutePen.setCapStyle(Qt::PenCapStyle::RoundCap);
-
-		for (int i = 0; i < (int)routeManager->getDefaultRoute().routePoints.size() - 1; ++i)
-		{
-			RoutePoint& rp1 = routeManager->getDefaultRoute().routePoints.at(i);
-			RoutePoint& rp2 = routeManager->getDefaultRoute().routePoints.at(i + 1);
-
-			paceRoutePen.setColor(rp2.color);
-
-			painter->setPen(paceRoutePen);
-			painter->setBrush(Qt::NoBrush);
-			painter->drawLine(rp1.position, rp2.position);
-		}
-	}
-
-	if (route.tailRenderMode == RouteRenderMode::Discreet || route.tailRenderMode == RouteRenderMode::Highlight)
-	{
-		QPen tailPen;
-		tailPen.setWidthF(route.tailWidth * route.userScale);
-		tailPen.setJoinStyle(Qt::PenJoinStyle::RoundJoin);
-		tailPen.setCapStyle(Qt::PenCapStyle::RoundCap);
-
-		QColor tailColor;
-
-		if (route.tailRenderMode == RouteRenderMode::Discreet)
-			tailColor = route.discreetColor;
-		else
-			tailColor = route.highlightColor;
-
-		tailPen.setColor(tailColor);
-
-		painter->setPen(tailPen);
-		painter->setBrush(Qt::NoBrush);
-		painter->drawPath(route.tailPath);
-	}
-
-	if (route.showControls)
-	{
-		QPen controlPen;
-		controlPen.setWidthF(route.controlBorderWidth * route.userScale);
-		controlPen.setColor(route.controlBorderColor);
-
-		double controlRadius = route.controlRadius * route.userScale;
-
-		painter->setPen(controlPen);
-		painter->setBrush(Qt::NoBrush);
-
-		for (const QPointF& controlPosition : routeManager->getDefaultRoute().controlPositions)
-			painter->drawEllipse(controlPosition, controlRadius, controlRadius);
-	}
-
-	if (route.showRunner)
-	{
-		QPen runnerPen;
-		QBrush runnerBrush;
-		runnerPen.setWidthF(route.runnerBorderWidth * route.userScale);
-		runnerPen.setColor(route.runnerBorderColor);
-		runnerBrush.setColor(route.runnerColor);
-		runnerBrush.setStyle(Qt::SolidPattern);
-
-		double runnerRadius = route.runnerRadius * route.runnerScale * route.userScale;
-
-		painter->setPen(runnerPen);
-		painter->setBrush(runnerBrush);
-		painter->drawEllipse(routeManager->getDefaultRoute().runnerPosition, runnerRadius, runnerRadius);
-	}
-
-	painter->setClipping(false);
-	painter->end();
-}
-
-void Renderer::renderInfoPanel()
-{
-	QFont font = QFont("DejaVu Sans", infoPanelFontSize, QFont::Bold);
-	QFontMetrics metrics(font);
-
-	int textX = 10;
-	int textY = 6;
-	int lineHeight = metrics.height();
-	int lineSpacing = metrics.lineSpacing() + 1;
-	int lineWidth1 = metrics.boundingRect("control offset:").width();
-	int lineWidth2 = metrics.boundingRect("99:99:99.999").width();
-	int rightPartMargin = 15;
-	int backgroundRadius = 10;
-	int backgroundWidth = textX + backgroundRadius + lineWidth1 + rightPartMargin + lineWidth2 + 10;
-	int backgroundHeight = lineSpacing * 18 + textY + 3;
-
-	QColor textColor = QColor(255, 255, 255, 200);
-	QColor textGreenColor = QColor(0, 255, 0, 200);
-	QColor textRedColor = QColor(255, 0, 0, 200);
-
-	painter->begin(paintDevice);
-	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform | QPainter::HighQualityAntialiasing);
-
-	painter->setPen(QColor(0, 0, 0));
-	painter->setBrush(QBrush(QColor(20, 20, 20, 220)));
-	painter->drawRoundedRect(-backgroundRadius, -backgroundRadius, backgroundWidth, backgroundHeight, backgroundRadius, backgroundRadius);
-
-	painter->setPen(textColor);
-	painter->setFont(font);
-
-	painter->drawText(textX, textY, lineWidth1, lineHeight, 0, "time:");
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "fps:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "frame:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "decode:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "stabilize:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "render:");
-
-	if (renderToOffscreen)
-		painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "encode:");
-	else
-		painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "spare:");
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "scroll:");
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "video scale:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "map scale:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "route scale:");
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "control offset:");
-	painter->drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "runner offset:");
-
-	textX += lineWidth1 + rightPartMargin;
-	textY = 6;
-
-	QTime currentTimeTemp = QTime(0, 0, 0, 0).addMSecs((int)(currentTime * 1000.0 + 0.5));
-	painter->drawText(textX, textY, lineWidth2, lineHeight, 0, currentTimeTemp.toString("HH:mm:ss.zzz"));
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(averageFps.getAverage(), 'f', 2));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageFrameDuration.getAverage(), 'f', 2)));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageDecodeDuration.getAverage(), 'f', 2)));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageStabilizeDuration.getAverage(), 'f', 2)));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageRenderDuration.getAverage(), 'f', 2)));
-
-	if (renderToOffscreen)
-		painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageEncodeDuration.getAverage(), 'f', 2)));
-	else
-	{
-		if (averageSpareTime.getAverage() < 0)
-			painter->setPen(textRedColor);
-		else if (averageSpareTime.getAverage() > 0)
-			painter->setPen(textGreenColor);
-
-		painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageSpareTime.getAverage(), 'f', 2)));
-		painter->setPen(textColor);
-	}
-
-	QString scrollText;
-
-	switch (inputHandler->getScrollMode())
-	{
-		case ScrollMode::None: scrollText = "none (seek)"; break;
-		case ScrollMode::Map: scrollText = "map"; break;
-		case ScrollMode::Video: scrollText = "video"; break;
-		default: scrollText = "unknown"; break;
-	}
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, scrollText);
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(videoPanel.userScale, 'f', 2));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(mapPanel.userScale, 'f', 2));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(routeManager->getDefaultRoute().userScale, 'f', 2));
-
-	textY += lineSpacing;
-
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 s").arg(QString::number(routeManager->getDefaultRoute().controlTimeOffset, 'f', 2)));
-	painter->drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 s").arg(QString::number(routeManager->getDefaultRoute().runnerTimeOffset, 'f', 2)));
-
-	painter->end();
-}
-
-Panel& Renderer::getVideoPanel()
-{
-	return videoPanel;
-}
-
-Panel& Renderer::getMapPanel()
-{
-	return mapPanel;
-}
-
-RenderMode Renderer::getRenderMode() const
-{
-	return renderMode;
-}
-
-void Renderer::setRenderMode(RenderMode mode)
-{
-	renderMode = mode;
-}
-
-void Renderer::toggleShowInfoPanel()
-{
-	showInfoPanel = !showInfoPanel;
-}
-
-void Renderer::requestFullClear()
-{
-	fullClearRequested = true;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <QOpenGLPixelTransferOptions>
+
+#include "Renderer.h"
+#include "VideoDecoder.h"
+#include "MapImageReader.h"
+#include "VideoStabilizer.h"
+#include "InputHandler.h"
+#include "RouteManager.h"
+#include "Settings.h"
+#include "FrameData.h"
+#include "CpuCompositor.h"
+
+using namespace OrientView;
+
+namespace
+{
+	// the order has to match the rows of the interpolation weight texture
+	const char* interpolationFunctionNames[] = { "triangle", "bell", "bspline", "catmullrom", "lanczos" };
+	const int interpolationFunctionCount = 5;
+	const int interpolationWeightCount = 256;
+
+	// can be tuned (1.0 - 3.0)
+	const double lanczosSize = 2.0;
+
+	// all functions take the argument range -2.0 - 2.0
+	const double xRange = 2.0;
+
+	double triangle(double x)
+	{
+		x = x / xRange;
+
+		if (x <= 0.0)
+			return (x + 1.0);
+		else
+			return (1.0 - x);
+	}
+
+	double bell(double x)
+	{
+		x = (x / xRange) * 1.5;
+
+		if (x >= -1.5 && x <= -0.5)
+			return 0.5 * (x + 1.5) * (x + 1.5);
+		else if (x > -0.5 && x <= 0.5)
+			return 3.0 / 4.0 - (x * x);
+		else if (x > 0.5 && x <= 1.5)
+			return 0.5 * (x - 1.5) * (x - 1.5);
+		else
+			return 0.0;
+	}
+
+	double bspline(double x)
+	{
+		x = (std::abs(x) / xRange) * 2.0;
+
+		if (x >= 0.0 && x <= 1.0)
+			return (2.0 / 3.0) + 0.5 * (x * x * x) - (x * x);
+		else if (x > 1.0 && x <= 2.0)
+			return (1.0 / 6.0) * (2.0 - x) * (2.0 - x) * (2.0 - x);
+		else
+			return 0.0;
+	}
+
+	double catmullrom(double x)
+	{
+		const double B = 0.0;
+		const double C = 0.5;
+
+		x = (std::abs(x) / xRange) * 2.0;
+
+		if (x < 1.0)
+			return ((12 - 9 * B - 6 * C) * (x * x * x) + (-18 + 12 * B + 6 * C) * (x * x) + (6 - 2 * B)) / 6.0;
+		else if (x >= 1.0 && x <= 2.0)
+			return ((-B - 6 * C) * (x * x * x) + (6 * B + 30 * C) * (x * x) + (-12 * B - 48 * C) * x + 8 * B + 24 * C) / 6.0;
+		else
+			return 0.0;
+	}
+
+	double sinc(double x)
+	{
+		return std::sin(M_PI * x) / (M_PI * x);
+	}
+
+	double lanczos(double x)
+	{
+		x = (std::abs(x) / xRange) * lanczosSize;
+
+		if (x == 0.0)
+			return 1.0;
+		else
+			return sinc(x) * sinc(x / lanczosSize);
+	}
+
+	double interpolationWeight(int function, double x)
+	{
+		switch (function)
+		{
+			case 0: return triangle(x);
+			case 1: return bell(x);
+			case 2: return bspline(x);
+			case 3: return catmullrom(x);
+			case 4: return lanczos(x);
+			default: return 0.0;
+		}
+	}
+}
+
+Panel::Panel() : texture(QOpenGLTexture::Target2D)
+{
+}
+
+bool InfoPanelValues::operator==(const InfoPanelValues& other) const
+{
+	return scrollMode == other.scrollMode &&
+		videoScale == other.videoScale &&
+		mapScale == other.mapScale &&
+		routeScale == other.routeScale &&
+		controlTimeOffset == other.controlTimeOffset &&
+		runnerTimeOffset == other.runnerTimeOffset;
+}
+
+bool InfoPanelValues::operator!=(const InfoPanelValues& other) const
+{
+	return !(*this == other);
+}
+
+bool Renderer::initialize(VideoDecoder* videoDecoder, MapImageReader* mapImageReader, VideoStabilizer* videoStabilizer, InputHandler* inputHandler, RouteManager* routeManager, Settings* settings, bool renderToOffscreen)
+{
+	qDebug("Initializing renderer");
+
+	this->mapImageReader = mapImageReader;
+	this->videoStabilizer = videoStabilizer;
+	this->inputHandler = inputHandler;
+	this->routeManager = routeManager;
+	this->renderToOffscreen = renderToOffscreen;
+
+	useCpuRenderer = renderToOffscreen && settings->encoder.useCpuRenderer;
+
+	videoPanel.clearColor = settings->video.backgroundColor;
+	videoPanel.clippingEnabled = settings->video.enableClipping;
+	videoPanel.clearingEnabled = settings->video.enableClearing;
+	videoPanel.userX = settings->video.x;
+	videoPanel.userY = settings->video.y;
+	videoPanel.userAngle = settings->video.angle;
+	videoPanel.userScale = settings->video.scale;
+	videoPanel.textureWidth = videoDecoder->getFrameWidth();
+	videoPanel.textureHeight = videoDecoder->getFrameHeight();
+	videoPanel.texelWidth = 1.0 / videoPanel.textureWidth;
+	videoPanel.texelHeight = 1.0 / videoPanel.textureHeight;
+
+	mapPanel.clearColor = settings->map.backgroundColor;
+	mapPanel.userX = settings->map.x;
+	mapPanel.userY = settings->map.y;
+	mapPanel.userAngle = settings->map.angle;
+	mapPanel.userScale = settings->map.scale;
+	mapPanel.textureWidth = mapImageReader->getMapWidth();
+	mapPanel.textureHeight = mapImageReader->getMapHeight();
+	mapPanel.texelWidth = 1.0 / mapPanel.textureWidth;
+	mapPanel.texelHeight = 1.0 / mapPanel.textureHeight;
+	mapPanel.relativeWidth = settings->map.relativeWidth;
+
+	multisamples = settings->window.multisamples;
+	renderMode = settings->renderer.renderMode;
+	showInfoPanel = settings->renderer.showInfoPanel;
+	infoPanelFontSize = settings->renderer.infoPanelFontSize;
+	infoPanelRefreshRate = settings->renderer.infoPanelRefreshRate;
+
+	const double averagingFactor = 0.005;
+	averageFps.setAlpha(averagingFactor);
+	averageFrameDuration.setAlpha(averagingFactor);
+	averageDecodeDuration.setAlpha(averagingFactor);
+	averageStabilizeDuration.setAlpha(averagingFactor);
+	averageRenderDuration.setAlpha(averagingFactor);
+	averageEncodeDuration.setAlpha(averagingFactor);
+	averageSpareTime.setAlpha(averagingFactor);
+
+	if (useCpuRenderer)
+		cpuCompositor = new CpuCompositor();
+	else
+		initializeOpenGLFunctions();
+
+	if (!windowResized(settings->window.width, settings->window.height))
+		return false;
+
+	// no OpenGL resources are needed, the video frames and map tiles are sampled straight from the images
+	if (useCpuRenderer)
+	{
+		videoFrameImage = QImage(videoPanel.textureWidth, videoPanel.textureHeight, QImage::Format_RGBA8888);
+		videoFrameImage.fill(Qt::black);
+
+		if (settings->video.rescaleShader != "default" || settings->map.rescaleShader != "default")
+			qWarning("Rescale shaders are not supported when rendering on CPU, using bilinear sampling");
+
+		if (!initializeInfoPanel())
+			return false;
+
+		painter = new QPainter();
+		paintTarget = &cpuCompositor->getFrameImage();
+
+		return true;
+	}
+
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+	if (mapImageReader->getMaxTileImageSize() > maxTextureSize)
+	{
+		qWarning("Map tile size is too large, maximum texture size is %d", maxTextureSize);
+		return false;
+	}
+
+	// 1 2
+	// 4 3
+	GLfloat videoPanelBuffer[] =
+	{
+		-(float)videoPanel.textureWidth / 2, (float)videoPanel.textureHeight / 2, 0.0f, // 1
+		(float)videoPanel.textureWidth / 2, (float)videoPanel.textureHeight / 2, 0.0f, // 2
+		(float)videoPanel.textureWidth / 2, -(float)videoPanel.textureHeight / 2, 0.0f, // 3
+		-(float)videoPanel.textureWidth / 2, -(float)videoPanel.textureHeight / 2, 0.0f, // 4
+
+		0.0f, 0.0f, // 1
+		1.0f, 0.0f, // 2
+		1.0f, 1.0f, // 3
+		0.0f, 1.0f  // 4
+	};
+
+	// 1 2
+	// 4 3
+	GLfloat mapPanelBuffer[] =
+	{
+		-(float)mapPanel.textureWidth / 2, (float)mapPanel.textureHeight / 2, 0.0f, // 1
+		(float)mapPanel.textureWidth / 2, (float)mapPanel.textureHeight / 2, 0.0f, // 2
+		(float)mapPanel.textureWidth / 2, -(float)mapPanel.textureHeight / 2, 0.0f, // 3
+		-(float)mapPanel.textureWidth / 2, -(float)mapPanel.textureHeight / 2, 0.0f, // 4
+
+		0.0f, 0.0f, // 1
+		1.0f, 0.0f, // 2
+		1.0f, 1.0f, // 3
+		0.0f, 1.0f  // 4
+	};
+
+	videoPanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+	videoPanel.vertexBuffer.create();
+	videoPanel.vertexBuffer.bind();
+	videoPanel.vertexBuffer.allocate(videoPanelBuffer, sizeof(GLfloat) * 20);
+	videoPanel.vertexBuffer.release();
+
+	// the map tiles are drawn one at a time by rewriting the vertex buffer
+	mapPanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+	mapPanel.vertexBuffer.create();
+	mapPanel.vertexBuffer.bind();
+	mapPanel.vertexBuffer.allocate(mapPanelBuffer, sizeof(GLfloat) * 20);
+	mapPanel.vertexBuffer.release();
+
+	videoPanel.texture.create();
+	videoPanel.texture.bind();
+	videoPanel.texture.setSize(videoPanel.textureWidth, videoPanel.textureHeight);
+	videoPanel.texture.setFormat(QOpenGLTexture::RGBA8_UNorm);
+	videoPanel.texture.setMinificationFilter(QOpenGLTexture::Linear);
+	videoPanel.texture.setMagnificationFilter(QOpenGLTexture::Linear);
+	videoPanel.texture.setWrapMode(QOpenGLTexture::ClampToEdge);
+	videoPanel.texture.allocateStorage();
+	videoPanel.texture.release();
+
+	// map tile textures are uploaded lazily when they become visible, and released again when the cache is full
+	mapTileTextures.resize(mapImageReader->getLevelCount());
+	mapTileCacheBudget = (size_t)std::max(1, settings->map.tileCacheSize) * 1024 * 1024;
+
+	for (int level = 0; level < mapImageReader->getLevelCount(); ++level)
+		mapTileTextures[level].resize(mapImageReader->getTiles(level).size());
+
+	if (!createInterpolationWeightTexture())
+		return false;
+
+	if (!loadPanelRescaleShader(videoPanel, settings->video.rescaleShader, settings->video.interpolationFunction))
+		return false;
+
+	// the map is drawn in tiles, which the separable rescaling does not support
+	if (settings->map.rescaleShader == "separable")
+	{
+		qWarning("Separable rescaling is not supported for the map, using the default shader");
+
+		if (!loadPanelRescaleShader(mapPanel, "default", settings->map.interpolationFunction))
+			return false;
+	}
+	else if (!loadPanelRescaleShader(mapPanel, settings->map.rescaleShader, settings->map.interpolationFunction))
+		return false;
+
+	if (!initializeInfoPanel())
+		return false;
+
+	paintDevice = new QOpenGLPaintDevice(windowWidth, windowHeight);
+	paintDevice->setPaintFlipped(renderToOffscreen);
+	paintTarget = paintDevice;
+	painter = new QPainter();
+
+	return true;
+}
+
+bool Renderer::createInterpolationWeightTexture()
+{
+	std::vector<float> weights(interpolationWeightCount * interpolationFunctionCount);
+
+	for (int function = 0; function < interpolationFunctionCount; ++function)
+	{
+		for (int i = 0; i < interpolationWeightCount; ++i)
+		{
+			double x = -xRange + (2.0 * xRange * i) / (interpolationWeightCount - 1);
+			weights[function * interpolationWeightCount + i] = (float)interpolationWeight(function, x);
+		}
+	}
+
+	interpolationWeightTexture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+	interpolationWeightTexture->create();
+	interpolationWeightTexture->bind();
+	interpolationWeightTexture->setSize(interpolationWeightCount, interpolationFunctionCount);
+	interpolationWeightTexture->setFormat(QOpenGLTexture::R32F);
+	interpolationWeightTexture->setMinificationFilter(QOpenGLTexture::Linear);
+	interpolationWeightTexture->setMagnificationFilter(QOpenGLTexture::Linear);
+	interpolationWeightTexture->setWrapMode(QOpenGLTexture::ClampToEdge);
+	interpolationWeightTexture->allocateStorage();
+	interpolationWeightTexture->setData(QOpenGLTexture::Red, QOpenGLTexture::Float32, weights.data());
+	interpolationWeightTexture->release();
+
+	if (!interpolationWeightTexture->isStorageAllocated())
+	{
+		qWarning("Could not create interpolation weight texture");
+		return false;
+	}
+
+	return true;
+}
+
+bool Renderer::initializeInfoPanel()
+{
+	infoPanelFont = QFont("DejaVu Sans", infoPanelFontSize, QFont::Bold);
+	QFontMetrics metrics(infoPanelFont);
+
+	int textX = 10;
+	int textY = 6;
+	int lineSpacing = metrics.lineSpacing() + 1;
+	int lineWidth1 = metrics.boundingRect("control offset:").width();
+	int lineWidth2 = metrics.boundingRect("99:99:99.999").width();
+	int rightPartMargin = 15;
+	int backgroundRadius = 10;
+	int backgroundWidth = textX + backgroundRadius + lineWidth1 + rightPartMargin + lineWidth2 + 10;
+	int lineCount = renderToOffscreen ? 18 : 20; // the frame pacing lines are only shown on screen
+	int backgroundHeight = lineSpacing * lineCount + textY + 3;
+
+	// the background is drawn partly outside of the window, only the visible part is stored
+	infoPanelImage = QImage(backgroundWidth - backgroundRadius + 1, backgroundHeight - backgroundRadius + 1, QImage::Format_ARGB32_Premultiplied);
+
+	infoPanel.textureWidth = infoPanelImage.width();
+	infoPanel.textureHeight = infoPanelImage.height();
+	infoPanel.texelWidth = 1.0 / infoPanel.textureWidth;
+	infoPanel.texelHeight = 1.0 / infoPanel.textureHeight;
+
+	infoPanelRefreshTimer.start();
+	infoPanelRefreshRequested = true;
+
+	// the image is drawn with QPainter when rendering on CPU
+	if (useCpuRenderer)
+		return true;
+
+	// 1 2
+	// 4 3
+	GLfloat infoPanelBuffer[] =
+	{
+		-(float)infoPanel.textureWidth / 2, (float)infoPanel.textureHeight / 2, 0.0f, // 1
+		(float)infoPanel.textureWidth / 2, (float)infoPanel.textureHeight / 2, 0.0f, // 2
+		(float)infoPanel.textureWidth / 2, -(float)infoPanel.textureHeight / 2, 0.0f, // 3
+		-(float)infoPanel.textureWidth / 2, -(float)infoPanel.textureHeight / 2, 0.0f, // 4
+
+		0.0f, 0.0f, // 1
+		1.0f, 0.0f, // 2
+		1.0f, 1.0f, // 3
+		0.0f, 1.0f  // 4
+	};
+
+	infoPanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+	infoPanel.vertexBuffer.create();
+	infoPanel.vertexBuffer.bind();
+	infoPanel.vertexBuffer.allocate(infoPanelBuffer, sizeof(GLfloat) * 20);
+	infoPanel.vertexBuffer.release();
+
+	infoPanel.texture.create();
+	infoPanel.texture.bind();
+	infoPanel.texture.setSize(infoPanel.textureWidth, infoPanel.textureHeight);
+	infoPanel.texture.setFormat(QOpenGLTexture::RGBA8_UNorm);
+	infoPanel.texture.setMinificationFilter(QOpenGLTexture::Nearest);
+	infoPanel.texture.setMagnificationFilter(QOpenGLTexture::Nearest);
+	infoPanel.texture.setWrapMode(QOpenGLTexture::ClampToEdge);
+	infoPanel.texture.allocateStorage();
+	infoPanel.texture.release();
+
+	if (!loadRescaleShader(infoPanel, "default"))
+		return false;
+
+	return true;
+}
+
+bool Renderer::windowResized(int newWidth, int newHeight)
+{
+	windowWidth = newWidth;
+	windowHeight = newHeight;
+
+	fullClearRequested = true;
+	isDirty = true;
+
+	if (renderToOffscreen && !useCpuRenderer)
+	{
+		QOpenGLFramebufferObjectFormat format;
+		format.setSamples(multisamples);
+		format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+
+		if (offscreenFramebuffer != nullptr)
+		{
+			delete offscreenFramebuffer;
+			offscreenFramebuffer = nullptr;
+		}
+
+		offscreenFramebuffer = new QOpenGLFramebufferObject(windowWidth, windowHeight, format);
+
+		if (!offscreenFramebuffer->isValid())
+		{
+			qWarning("Could not create main frame buffer");
+			return false;
+		}
+
+		format.setSamples(0);
+
+		if (offscreenFramebufferNonMultisample != nullptr)
+		{
+			delete offscreenFramebufferNonMultisample;
+			offscreenFramebufferNonMultisample = nullptr;
+		}
+
+		offscreenFramebufferNonMultisample = new QOpenGLFramebufferObject(windowWidth, windowHeight, format);
+
+		if (!offscreenFramebufferNonMultisample->isValid())
+		{
+			qWarning("Could not create non multisampled main frame buffer");
+			return false;
+		}
+	}
+
+	if (renderToOffscreen)
+	{
+		if (renderedFrameData.data != nullptr)
+		{
+			delete renderedFrameData.data;
+			renderedFrameData.data = nullptr;
+		}
+
+		renderedFrameData = FrameData();
+		renderedFrameData.dataLength = (size_t)(windowWidth * windowHeight * 4);
+		renderedFrameData.rowLength = (size_t)(windowWidth * 4);
+		renderedFrameData.width = windowWidth;
+		renderedFrameData.height = windowHeight;
+
+		// the CPU renderer composites into its own frame data, the OpenGL renderer reads back straight to the caller's buffer
+		if (useCpuRenderer)
+		{
+			renderedFrameData.data = new uint8_t[renderedFrameData.dataLength];
+
+			if (!cpuCompositor->initialize(renderedFrameData.data, windowWidth, windowHeight, renderedFrameData.rowLength))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+Renderer::~Renderer()
+{
+	for (Panel* panel : { &videoPanel, &mapPanel })
+	{
+		if (panel->verticalFramebuffer != nullptr)
+		{
+			delete panel->verticalFramebuffer;
+			panel->verticalFramebuffer = nullptr;
+		}
+
+		if (panel->horizontalFramebuffer != nullptr)
+		{
+			delete panel->horizontalFramebuffer;
+			panel->horizontalFramebuffer = nullptr;
+		}
+	}
+
+	if (interpolationWeightTexture != nullptr)
+	{
+		delete interpolationWeightTexture;
+		interpolationWeightTexture = nullptr;
+	}
+
+	for (std::vector<MapTileTexture>& levelTextures : mapTileTextures)
+	{
+		for (MapTileTexture& tileTexture : levelTextures)
+		{
+			if (tileTexture.texture != nullptr)
+			{
+				delete tileTexture.texture;
+				tileTexture.texture = nullptr;
+			}
+		}
+	}
+
+	if (cpuCompositor != nullptr)
+	{
+		delete cpuCompositor;
+		cpuCompositor = nullptr;
+	}
+
+	if (renderedFrameData.data != nullptr)
+	{
+		delete renderedFrameData.data;
+		renderedFrameData.data = nullptr;
+	}
+
+	if (offscreenFramebufferNonMultisample != nullptr)
+	{
+		delete offscreenFramebufferNonMultisample;
+		offscreenFramebufferNonMultisample = nullptr;
+	}
+
+	if (offscreenFramebuffer != nullptr)
+	{
+		delete offscreenFramebuffer;
+		offscreenFramebuffer = nullptr;
+	}
+
+	if (painter != nullptr)
+	{
+		delete painter;
+		painter = nullptr;
+	}
+
+	if (paintDevice != nullptr)
+	{
+		delete paintDevice;
+		paintDevice = nullptr;
+	}
+}
+
+bool Renderer::loadRescaleShader(Panel& panel, const QString& shaderName)
+{
+	if (!panel.shaderProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, QString("data/shaders/rescale_%1.vert").arg(shaderName)))
+		return false;
+
+	if (!panel.shaderProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, QString("data/shaders/rescale_%1.frag").arg(shaderName)))
+		return false;
+
+	if (!panel.shaderProgram.link())
+		return false;
+
+	panel.vertexArrayObject.create();
+	panel.vertexArrayObject.bind();
+
+	panel.vertexBuffer.bind();
+	panel.shaderProgram.enableAttributeArray("vertexPosition");
+	panel.shaderProgram.enableAttributeArray("vertexTextureCoordinate");
+	panel.shaderProgram.setAttributeBuffer("vertexPosition", GL_FLOAT, 0, 3, 0);
+	panel.shaderProgram.setAttributeBuffer("vertexTextureCoordinate", GL_FLOAT, sizeof(GLfloat) * 12, 2, 0);
+
+	panel.vertexArrayObject.release();
+	panel.vertexBuffer.release();
+
+	return true;
+}
+
+bool Renderer::loadPanelRescaleShader(Panel& panel, const QString& shaderName, const QString& interpolationFunction)
+{
+	panel.interpolationFunction = -1;
+
+	for (int i = 0; i < interpolationFunctionCount; ++i)
+	{
+		if (interpolationFunction == interpolationFunctionNames[i])
+			panel.interpolationFunction = i;
+	}
+
+	if (panel.interpolationFunction < 0)
+	{
+		qWarning("Unknown interpolation function: %s", qPrintable(interpolationFunction));
+		return false;
+	}
+
+	// the separable rescaling renders through two intermediate framebuffers, the result is then drawn with the default shader
+	if (shaderName == "separable")
+	{
+		panel.separableRescaling = true;
+
+		if (!separableRescalePanel.shaderProgram.isLinked())
+		{
+			// 1 2
+			// 4 3
+			GLfloat separableRescaleBuffer[] =
+			{
+				-1.0f, 1.0f, 0.0f, // 1
+				1.0f, 1.0f, 0.0f, // 2
+				1.0f, -1.0f, 0.0f, // 3
+				-1.0f, -1.0f, 0.0f, // 4
+
+				0.0f, 1.0f, // 1
+				1.0f, 1.0f, // 2
+				1.0f, 0.0f, // 3
+				0.0f, 0.0f  // 4
+			};
+
+			separableRescalePanel.vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+			separableRescalePanel.vertexBuffer.create();
+			separableRescalePanel.vertexBuffer.bind();
+			separableRescalePanel.vertexBuffer.allocate(separableRescaleBuffer, sizeof(GLfloat) * 20);
+			separableRescalePanel.vertexBuffer.release();
+
+			if (!loadRescaleShader(separableRescalePanel, "separable"))
+				return false;
+		}
+
+		return loadRescaleShader(panel, "default");
+	}
+
+	return loadRescaleShader(panel, shaderName);
+}
+
+void Renderer::startRendering(double currentTime, double frameDuration, double decodeDuration, double stabilizeDuration, double encodeDuration, double spareTime)
+{
+	renderDurationTimer.restart();
+
+	this->currentTime = currentTime;
+
+	averageFps.addMeasurement(1000.0 / frameDuration, frameDuration);
+	averageFrameDuration.addMeasurement(frameDuration, frameDuration);
+	averageDecodeDuration.addMeasurement(decodeDuration, frameDuration);
+	averageStabilizeDuration.addMeasurement(stabilizeDuration, frameDuration);
+	averageRenderDuration.addMeasurement(renderDuration, frameDuration);
+	averageEncodeDuration.addMeasurement(encodeDuration, frameDuration);
+	averageSpareTime.addMeasurement(spareTime, frameDuration);
+
+	if (useCpuRenderer)
+		return;
+
+	paintDevice->setSize(QSize(windowWidth, windowHeight));
+
+	glViewport(0, 0, windowWidth, windowHeight);
+	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	glDisable(GL_DEPTH_TEST);
+}
+
+void Renderer::uploadFrameData(const FrameData& frameData)
+{
+	if (frameData.data != nullptr && frameData.width > 0 && frameData.height > 0)
+	{
+		if (useCpuRenderer)
+		{
+			// the decoder reuses its buffer after the frame has been read, so the frame has to be copied
+			int rowLength = std::min((int)frameData.rowLength, videoFrameImage.bytesPerLine());
+			int height = std::min((int)frameData.height, videoFrameImage.height());
+
+			for (int y = 0; y < height; ++y)
+				memcpy(videoFrameImage.scanLine(y), frameData.data + y * frameData.rowLength, rowLength);
+		}
+		else
+		{
+			QOpenGLPixelTransferOptions options;
+
+			options.setRowLength((int)(frameData.rowLength / 4));
+			options.setImageHeight(frameData.height);
+			options.setAlignment(1);
+
+			videoPanel.texture.setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, frameData.data, &options);
+		}
+
+		isDirty = true;
+	}
+}
+
+void Renderer::renderAll()
+{
+	isDirty = false;
+
+	if (renderToOffscreen && !useCpuRenderer)
+		offscreenFramebuffer->bind();
+
+	if (renderMode == RenderMode::All || renderMode == RenderMode::Video)
+		renderVideoPanel();
+
+	if (renderMode == RenderMode::All || renderMode == RenderMode::Map)
+	{
+		renderMapPanel();
+		renderRoutes();
+
+		if (mapPanel.clippingEnabled)
+		{
+			int mapRightBorderX = (int)(mapPanel.relativeWidth * windowWidth + 0.5);
+
+			painter->begin(paintTarget);
+			painter->setPen(QColor(0, 0, 0));
+			painter->drawLine(mapRightBorderX, 0, mapRightBorderX, (int)windowHeight);
+			painter->end();
+		}
+	}
+
+	if (showInfoPanel)
+		renderInfoPanel();
+
+	if (renderToOffscreen && !useCpuRenderer)
+		offscreenFramebuffer->release();
+}
+
+void Renderer::stopRendering()
+{
+	renderDuration = renderDurationTimer.nsecsElapsed() / 1000000.0;
+}
+
+// Reads the rendered frame to the data buffer of the frame data, which needs to hold getRenderedFrameLength() bytes.
+void Renderer::getRenderedFrame(FrameData& frameData)
+{
+	if (!renderToOffscreen)
+		return;
+
+	frameData.dataLength = renderedFrameData.dataLength;
+	frameData.rowLength = renderedFrameData.rowLength;
+	frameData.width = renderedFrameData.width;
+	frameData.height = renderedFrameData.height;
+
+	if (useCpuRenderer)
+	{
+		memcpy(frameData.data, renderedFrameData.data, renderedFrameData.dataLength);
+		return;
+	}
+
+	QOpenGLFramebufferObject* sourceFbo = offscreenFramebuffer;
+
+	// pixels cannot be directly read from a multisampled framebuffer
+	// copy the framebuffer to a non-multisampled framebuffer and continue
+	if (sourceFbo->format().samples() != 0)
+	{
+		QRect rect(0, 0, windowWidth, windowHeight);
+		QOpenGLFramebufferObject::blitFramebuffer(offscreenFramebufferNonMultisample, rect, sourceFbo, rect);
+		sourceFbo = offscreenFramebufferNonMultisample;
+	}
+
+	sourceFbo->bind();
+	glReadPixels(0, 0, windowWidth, windowHeight, GL_RGBA, GL_UNSIGNED_BYTE, frameData.data);
+	sourceFbo->release();
+}
+
+size_t Renderer::getRenderedFrameLength() const
+{
+	return renderedFrameData.dataLength;
+}
+
+void Renderer::updateVideoPanelMatrix()
+{
+	videoPanel.vertexMatrix.setToIdentity();
+
+	if (!renderToOffscreen)
+		videoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, -windowHeight / 2, windowHeight / 2, 0.0f, 1.0f);
+	else
+		videoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, windowHeight / 2, -windowHeight / 2, 0.0f, 1.0f);
+
+	if (renderMode != RenderMode::Video)
+	{
+		videoPanel.offsetX = (windowWidth / 2.0) - (((1.0 - mapPanel.relativeWidth) * windowWidth) / 2.0);
+		videoPanel.scale = ((1.0 - mapPanel.relativeWidth) * windowWidth) / videoPanel.textureWidth;
+	}
+	else
+	{
+		videoPanel.offsetX = 0.0;
+		videoPanel.scale = windowWidth / videoPanel.textureWidth;
+	}
+
+	if (videoPanel.scale * videoPanel.textureHeight > windowHeight)
+		videoPanel.scale = windowHeight / videoPanel.textureHeight;
+
+	videoPanel.vertexMatrix.translate(videoPanel.offsetX, videoPanel.offsetY); // window coordinate units
+	videoPanel.vertexMatrix.translate( // scaled map pixel units
+		videoPanel.x + videoPanel.userX + videoStabilizer->getX() * videoPanel.textureWidth * videoPanel.scale * videoPanel.userScale,
+		videoPanel.y + videoPanel.userY - videoStabilizer->getY() * videoPanel.textureHeight * videoPanel.scale * videoPanel.userScale);
+	videoPanel.vertexMatrix.rotate(videoPanel.angle + videoPanel.userAngle - videoStabilizer->getAngle(), 0.0f, 0.0f, 1.0f);
+	videoPanel.vertexMatrix.scale(videoPanel.scale * videoPanel.userScale);
+}
+
+void Renderer::updateMapPanelMatrix()
+{
+	mapPanel.vertexMatrix.setToIdentity();
+
+	if (!renderToOffscreen)
+		mapPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, -windowHeight / 2, windowHeight / 2, 0.0f, 1.0f);
+	else
+		mapPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, windowHeight / 2, -windowHeight / 2, 0.0f, 1.0f);
+
+	if (renderMode != RenderMode::Map)
+		mapPanel.offsetX = -((windowWidth / 2.0) - ((mapPanel.relativeWidth * windowWidth) / 2.0));
+	else
+		mapPanel.offsetX = 0.0;
+
+	mapPanel.vertexMatrix.translate(mapPanel.offsetX, mapPanel.offsetY); // window coordinate units
+	mapPanel.vertexMatrix.rotate(mapPanel.angle + mapPanel.userAngle + routeManager->getAngle(), 0.0f, 0.0f, 1.0f);
+	mapPanel.vertexMatrix.scale(mapPanel.scale * mapPanel.userScale * routeManager->getScale());
+	mapPanel.vertexMatrix.translate(mapPanel.x + mapPanel.userX + routeManager->getX(), mapPanel.y + mapPanel.userY + routeManager->getY()); // map pixel units
+
+	mapPanel.clippingEnabled = (renderMode == RenderMode::All);
+}
+
+// The scissor rectangle is in window coordinates with the origin at the bottom left corner.
+QRect Renderer::getVideoPanelScissorRect() const
+{
+	double videoPanelWidth = videoPanel.scale * videoPanel.userScale * videoPanel.textureWidth;
+	double videoPanelHeight = videoPanel.scale * videoPanel.userScale * videoPanel.textureHeight;
+	double leftMargin = (windowWidth - videoPanelWidth) / 2.0;
+	double bottomMargin = (windowHeight - videoPanelHeight) / 2.0;
+
+	return QRect((int)(leftMargin + videoPanel.x + videoPanel.userX + videoPanel.offsetX + 0.5),
+		(int)(bottomMargin + videoPanel.y + videoPanel.userY + videoPanel.offsetY + 0.5),
+		(int)(videoPanelWidth + 0.5),
+		(int)(videoPanelHeight + 0.5));
+}
+
+void Renderer::renderVideoPanel()
+{
+	updateVideoPanelMatrix();
+
+	if (useCpuRenderer)
+	{
+		renderVideoPanelOnCpu();
+		return;
+	}
+
+	if (fullClearRequested)
+	{
+		glClearColor(videoPanel.clearColor.redF(), videoPanel.clearColor.greenF(), videoPanel.clearColor.blueF(), 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		fullClearRequested = false;
+	}
+
+	if (videoPanel.separableRescaling)
+		renderSeparableRescale(videoPanel);
+
+	if (videoPanel.clippingEnabled)
+	{
+		QRect scissorRect = getVideoPanelScissorRect();
+
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(scissorRect.x(), scissorRect.y(), scissorRect.width(), scissorRect.height());
+	}
+
+	if (videoPanel.clearingEnabled)
+	{
+		glClearColor(videoPanel.clearColor.redF(), videoPanel.clearColor.greenF(), videoPanel.clearColor.blueF(), 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	renderPanel(videoPanel);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+void Renderer::renderVideoPanelOnCpu()
+{
+	QRect frameRect(0, 0, (int)windowWidth, (int)windowHeight);
+	QRect clipRect = frameRect;
+
+	if (fullClearRequested)
+	{
+		cpuCompositor->fill(frameRect, videoPanel.clearColor);
+		fullClearRequested = false;
+	}
+
+	if (videoPanel.clippingEnabled)
+	{
+		// the frame rows go from top to bottom
+		QRect scissorRect = getVideoPanelScissorRect();
+		clipRect = QRect(scissorRect.x(), (int)windowHeight - scissorRect.y() - scissorRect.height(), scissorRect.width(), scissorRect.height());
+	}
+
+	if (videoPanel.clearingEnabled)
+		cpuCompositor->fill(clipRect, videoPanel.clearColor);
+
+	QRectF panelRect(QPointF(-videoPanel.textureWidth / 2.0, videoPanel.textureHeight / 2.0), QPointF(videoPanel.textureWidth / 2.0, -videoPanel.textureHeight / 2.0));
+	cpuCompositor->drawImage(videoFrameImage, videoFrameImage.rect(), getPanelTransform(videoPanel, panelRect, videoFrameImage.rect()), clipRect);
+	cpuCompositor->finishDrawing();
+}
+
+void Renderer::renderMapPanel()
+{
+	updateMapPanelMatrix();
+
+	if (useCpuRenderer)
+	{
+		renderMapPanelOnCpu();
+		return;
+	}
+
+	if (fullClearRequested)
+	{
+		glClearColor(mapPanel.clearColor.redF(), mapPanel.clearColor.greenF(), mapPanel.clearColor.blueF(), 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		fullClearRequested = false;
+	}
+
+	if (mapPanel.clippingEnabled)
+	{
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(0, 0, (int)(mapPanel.relativeWidth * windowWidth + 0.5), (int)windowHeight);
+	}
+
+	if (mapPanel.clearingEnabled)
+	{
+		glClearColor(mapPanel.clearColor.redF(), mapPanel.clearColor.greenF(), mapPanel.clearColor.blueF(), 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	renderMapTiles();
+	glDisable(GL_SCISSOR_TEST);
+}
+
+void Renderer::renderMapPanelOnCpu()
+{
+	QRect frameRect(0, 0, (int)windowWidth, (int)windowHeight);
+	QRect clipRect = frameRect;
+
+	if (fullClearRequested)
+	{
+		cpuCompositor->fill(frameRect, mapPanel.clearColor);
+		fullClearRequested = false;
+	}
+
+	if (mapPanel.clippingEnabled)
+		clipRect = QRect(0, 0, (int)(mapPanel.relativeWidth * windowWidth + 0.5), (int)windowHeight);
+
+	if (mapPanel.clearingEnabled)
+		cpuCompositor->fill(clipRect, mapPanel.clearColor);
+
+	int level = getMapTileLevel();
+	const std::vector<MapTile>& tiles = mapImageReader->getTiles(level);
+
+	for (int i : getVisibleMapTiles(level))
+	{
+		const MapTile& tile = tiles.at(i);
+		cpuCompositor->drawImage(tile.image, tile.imageRect, getPanelTransform(mapPanel, getMapTilePanelRect(tile), tile.imageRect), clipRect);
+	}
+
+	// all the visible tiles are drawn as one batch
+	cpuCompositor->finishDrawing();
+}
+
+void Renderer::renderMapTiles()
+{
+	int level = getMapTileLevel();
+	mapTileFrameIndex++;
+
+	mapPanel.shaderProgram.bind();
+	mapPanel.shaderProgram.setUniformValue("vertexMatrix", mapPanel.vertexMatrix);
+	mapPanel.shaderProgram.setUniformValue("textureSampler", 0);
+	mapPanel.shaderProgram.setUniformValue("weightSampler", 1);
+	mapPanel.shaderProgram.setUniformValue("interpolationFunction", mapPanel.interpolationFunction);
+
+	mapPanel.vertexArrayObject.bind();
+	interpolationWeightTexture->bind(1, QOpenGLTexture::ResetTextureUnit);
+
+	const std::vector<MapTile>& tiles = mapImageReader->getTiles(level);
+
+	for (int i : getVisibleMapTiles(level))
+	{
+		const MapTile& tile = tiles.at(i);
+		QRectF panelRect = getMapTilePanelRect(tile);
+
+		double imageWidth = tile.image.width();
+		double imageHeight = tile.image.height();
+		double u1 = tile.imageRect.x() / imageWidth;
+		double u2 = (tile.imageRect.x() + tile.imageRect.width()) / imageWidth;
+		double v1 = tile.imageRect.y() / imageHeight;
+		double v2 = (tile.imageRect.y() + tile.imageRect.height()) / imageHeight;
+
+		// 1 2
+		// 4 3
+		GLfloat tileBuffer[] =
+		{
+			(float)panelRect.left(), (float)panelRect.top(), 0.0f, // 1
+			(float)panelRect.right(), (float)panelRect.top(), 0.0f, // 2
+			(float)panelRect.right(), (float)panelRect.bottom(), 0.0f, // 3
+			(float)panelRect.left(), (float)panelRect.bottom(), 0.0f, // 4
+
+			(float)u1, (float)v1, // 1
+			(float)u2, (float)v1, // 2
+			(float)u2, (float)v2, // 3
+			(float)u1, (float)v2  // 4
+		};
+
+		mapPanel.vertexBuffer.bind();
+		mapPanel.vertexBuffer.write(0, tileBuffer, sizeof(GLfloat) * 20);
+		mapPanel.vertexBuffer.release();
+
+		mapPanel.shaderProgram.setUniformValue("textureWidth", (float)imageWidth);
+		mapPanel.shaderProgram.setUniformValue("textureHeight", (float)imageHeight);
+		mapPanel.shaderProgram.setUniformValue("texelWidth", (float)(1.0 / imageWidth));
+		mapPanel.shaderProgram.setUniformValue("texelHeight", (float)(1.0 / imageHeight));
+
+		QOpenGLTexture* texture = getMapTileTexture(level, i);
+		texture->bind();
+
+		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+		texture->release();
+	}
+
+	interpolationWeightTexture->release(1, QOpenGLTexture::ResetTextureUnit);
+	mapPanel.vertexArrayObject.release();
+	mapPanel.shaderProgram.release();
+
+	releaseMapTileTextures();
+}
+
+// Picks the coarsest pyramid level that still has at least one texel per screen pixel.
+int Renderer::getMapTileLevel() const
+{
+	double mapZoom = mapPanel.scale * mapPanel.userScale * routeManager->getScale();
+	int level = (mapZoom > 0.0) ? (int)std::floor(std::log2(1.0 / mapZoom)) : 0;
+
+	return std::max(0, std::min(level, mapImageReader->getLevelCount() - 1));
+}
+
+std::vector<int> Renderer::getVisibleMapTiles(int level) const
+{
+	// project the window corners back to the map panel coordinates to find the visible area
+	QMatrix4x4 inverseVertexMatrix = mapPanel.vertexMatrix.inverted();
+	QPolygonF windowPolygon;
+	windowPolygon << inverseVertexMatrix.map(QPointF(-1.0, -1.0));
+	windowPolygon << inverseVertexMatrix.map(QPointF(1.0, -1.0));
+	windowPolygon << inverseVertexMatrix.map(QPointF(1.0, 1.0));
+	windowPolygon << inverseVertexMatrix.map(QPointF(-1.0, 1.0));
+	QRectF visibleRect = windowPolygon.boundingRect();
+
+	const std::vector<MapTile>& tiles = mapImageReader->getTiles(level);
+	std::vector<int> visibleTiles;
+
+	for (int i = 0; i < (int)tiles.size(); ++i)
+	{
+		QRectF panelRect = getMapTilePanelRect(tiles.at(i));
+
+		if (panelRect.right() < visibleRect.left() || panelRect.left() > visibleRect.right() || panelRect.top() < visibleRect.top() || panelRect.bottom() > visibleRect.bottom())
+			continue;
+
+		visibleTiles.push_back(i);
+	}
+
+	return visibleTiles;
+}
+
+// The returned rectangle has its y axis pointing up like the panel coordinates, so its height is negative.
+QRectF Renderer::getMapTilePanelRect(const MapTile& tile) const
+{
+	double halfMapWidth = mapPanel.textureWidth / 2.0;
+	double halfMapHeight = mapPanel.textureHeight / 2.0;
+
+	// map image y axis points down, panel y axis points up
+	return QRectF(QPointF(tile.mapRect.left() - halfMapWidth, halfMapHeight - tile.mapRect.top()), QPointF(tile.mapRect.right() - halfMapWidth, halfMapHeight - tile.mapRect.bottom()));
+}
+
+QOpenGLTexture* Renderer::getMapTileTexture(int level, int index)
+{
+	MapTileTexture& tileTexture = mapTileTextures[level][index];
+	tileTexture.lastUsedFrame = mapTileFrameIndex;
+
+	if (tileTexture.texture == nullptr)
+	{
+		const QImage& image = mapImageReader->getTiles(level).at(index).image;
+
+		tileTexture.texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+		tileTexture.texture->create();
+		tileTexture.texture->bind();
+		tileTexture.texture->setData(image, QOpenGLTexture::GenerateMipMaps);
+		tileTexture.texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+		tileTexture.texture->setMagnificationFilter(QOpenGLTexture::Linear);
+		tileTexture.texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+		tileTexture.texture->release();
+
+		// RGBA texels and a third more for the mipmaps
+		tileTexture.size = (size_t)image.width() * image.height() * 4 * 4 / 3;
+		mapTileCacheSize += tileTexture.size;
+	}
+
+	return tileTexture.texture;
+}
+
+// Releases the least recently visible tile textures until the cache fits its budget. The tiles of the current frame are always kept.
+void Renderer::releaseMapTileTextures()
+{
+	if (mapTileCacheSize <= mapTileCacheBudget)
+		return;
+
+	std::vector<MapTileTexture*> loadedTextures;
+
+	for (std::vector<MapTileTexture>& levelTextures : mapTileTextures)
+	{
+		for (MapTileTexture& tileTexture : levelTextures)
+		{
+			if (tileTexture.texture != nullptr && tileTexture.lastUsedFrame != mapTileFrameIndex)
+				loadedTextures.push_back(&tileTexture);
+		}
+	}
+
+	std::sort(loadedTextures.begin(), loadedTextures.end(), [](const MapTileTexture* t1, const MapTileTexture* t2) { return t1->lastUsedFrame < t2->lastUsedFrame; });
+
+	for (MapTileTexture* tileTexture : loadedTextures)
+	{
+		if (mapTileCacheSize <= mapTileCacheBudget)
+			break;
+
+		delete tileTexture->texture;
+		tileTexture->texture = nullptr;
+		mapTileCacheSize -= tileTexture->size;
+		tileTexture->size = 0;
+	}
+}
+
+// Maps the source image pixel coordinates to the rendered frame pixel coordinates, the source rectangle covering the panel rectangle.
+QTransform Renderer::getPanelTransform(const Panel& panel, const QRectF& panelRect, const QRectF& sourceRect) const
+{
+	auto toFramePixel = [&](const QPointF& point)
+	{
+		QPointF normalizedPoint = panel.vertexMatrix.map(point);
+		return QPointF((normalizedPoint.x() + 1.0) / 2.0 * windowWidth, (normalizedPoint.y() + 1.0) / 2.0 * windowHeight);
+	};
+
+	QPointF topLeft = toFramePixel(panelRect.topLeft());
+	QPointF topRight = toFramePixel(panelRect.topRight());
+	QPointF bottomLeft = toFramePixel(panelRect.bottomLeft());
+
+	double m11 = (topRight.x() - topLeft.x()) / sourceRect.width();
+	double m12 = (topRight.y() - topLeft.y()) / sourceRect.width();
+	double m21 = (bottomLeft.x() - topLeft.x()) / sourceRect.height();
+	double m22 = (bottomLeft.y() - topLeft.y()) / sourceRect.height();
+
+	return QTransform(m11, m12, m21, m22, topLeft.x() - m11 * sourceRect.x() - m21 * sourceRect.y(), topLeft.y() - m12 * sourceRect.x() - m22 * sourceRect.y());
+}
+
+void Renderer::renderPanel(Panel& panel)
+{
+	panel.shaderProgram.bind();
+
+	panel.shaderProgram.setUniformValue("vertexMatrix", panel.vertexMatrix);
+	panel.shaderProgram.setUniformValue("textureSampler", 0);
+	panel.shaderProgram.setUniformValue("weightSampler", 1);
+	panel.shaderProgram.setUniformValue("interpolationFunction", panel.interpolationFunction);
+	panel.shaderProgram.setUniformValue("textureWidth", (float)panel.textureWidth);
+	panel.shaderProgram.setUniformValue("textureHeight", (float)panel.textureHeight);
+	panel.shaderProgram.setUniformValue("texelWidth", (float)panel.texelWidth);
+	panel.shaderProgram.setUniformValue("texelHeight", (float)panel.texelHeight);
+
+	panel.vertexArrayObject.bind();
+	interpolationWeightTexture->bind(1, QOpenGLTexture::ResetTextureUnit);
+
+	if (panel.separableRescaling)
+		glBindTexture(GL_TEXTURE_2D, panel.verticalFramebuffer->texture());
+	else
+		panel.texture.bind();
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+	if (panel.separableRescaling)
+		glBindTexture(GL_TEXTURE_2D, 0);
+	else
+		panel.texture.release();
+
+	interpolationWeightTexture->release(1, QOpenGLTexture::ResetTextureUnit);
+	panel.vertexArrayObject.release();
+	panel.shaderProgram.release();
+}
+
+// Rescales the panel texture to its final on screen size, first horizontally and then vertically.
+// Rotation and translation are left to the final draw, which samples the result with hardware bilinear.
+void Renderer::renderSeparableRescale(Panel& panel)
+{
+	int sourceWidth = (int)panel.textureWidth;
+	int sourceHeight = (int)panel.textureHeight;
+	int scaledWidth = std::max(1, std::min((int)(panel.textureWidth * panel.scale * panel.userScale + 0.5), maxTextureSize));
+	int scaledHeight = std::max(1, std::min((int)(panel.textureHeight * panel.scale * panel.userScale + 0.5), maxTextureSize));
+
+	if (panel.horizontalFramebuffer == nullptr || panel.horizontalFramebuffer->size() != QSize(scaledWidth, sourceHeight))
+	{
+		if (panel.horizontalFramebuffer != nullptr)
+		{
+			delete panel.horizontalFramebuffer;
+			panel.horizontalFramebuffer = nullptr;
+		}
+
+		panel.horizontalFramebuffer = new QOpenGLFramebufferObject(scaledWidth, sourceHeight);
+	}
+
+	if (panel.verticalFramebuffer == nullptr || panel.verticalFramebuffer->size() != QSize(scaledWidth, scaledHeight))
+	{
+		if (panel.verticalFramebuffer != nullptr)
+		{
+			delete panel.verticalFramebuffer;
+			panel.verticalFramebuffer = nullptr;
+		}
+
+		panel.verticalFramebuffer = new QOpenGLFramebufferObject(scaledWidth, scaledHeight);
+
+		glBindTexture(GL_TEXTURE_2D, panel.verticalFramebuffer->texture());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	QOpenGLShaderProgram& shaderProgram = separableRescalePanel.shaderProgram;
+
+	shaderProgram.bind();
+	shaderProgram.setUniformValue("vertexMatrix", QMatrix4x4());
+	shaderProgram.setUniformValue("textureSampler", 0);
+	shaderProgram.setUniformValue("weightSampler", 1);
+	shaderProgram.setUniformValue("interpolationFunction", panel.interpolationFunction);
+
+	separableRescalePanel.vertexArrayObject.bind();
+	interpolationWeightTexture->bind(1, QOpenGLTexture::ResetTextureUnit);
+
+	// horizontal pass: source texture -> scaled width, source height
+	panel.horizontalFramebuffer->bind();
+	glViewport(0, 0, scaledWidth, sourceHeight);
+
+	shaderProgram.setUniformValue("textureWidth", (float)sourceWidth);
+	shaderProgram.setUniformValue("textureHeight", (float)sourceHeight);
+	shaderProgram.setUniformValue("direction", QVector2D(1.0f, 0.0f));
+
+	panel.texture.bind();
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	panel.texture.release();
+
+	// vertical pass: horizontal pass result -> scaled width, scaled height
+	panel.verticalFramebuffer->bind();
+	glViewport(0, 0, scaledWidth, scaledHeight);
+
+	shaderProgram.setUniformValue("textureWidth", (float)scaledWidth);
+	shaderProgram.setUniformValue("textureHeight", (float)sourceHeight);
+	shaderProgram.setUniformValue("direction", QVector2D(0.0f, 1.0f));
+
+	glBindTexture(GL_TEXTURE_2D, panel.horizontalFramebuffer->texture());
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	interpolationWeightTexture->release(1, QOpenGLTexture::ResetTextureUnit);
+	separableRescalePanel.vertexArrayObject.release();
+	shaderProgram.release();
+
+	if (renderToOffscreen)
+		offscreenFramebuffer->bind();
+	else
+		QOpenGLFramebufferObject::bindDefault();
+
+	glViewport(0, 0, windowWidth, windowHeight);
+}
+
+// Maps the route positions to window coordinates.
+QMatrix Renderer::getRouteMatrix() const
+{
+	QMatrix routeMatrix;
+	routeMatrix.translate(windowWidth / 2.0, windowHeight / 2.0);
+	routeMatrix.translate(mapPanel.offsetX, mapPanel.offsetY);
+	routeMatrix.rotate(-(mapPanel.angle + mapPanel.userAngle + routeManager->getAngle()));
+	routeMatrix.scale(mapPanel.scale * mapPanel.userScale * routeManager->getScale(), mapPanel.scale * mapPanel.userScale * routeManager->getScale());
+	routeMatrix.translate(mapPanel.x + mapPanel.userX + routeManager->getX(), -(mapPanel.y + mapPanel.userY + routeManager->getY()));
+
+	return routeMatrix;
+}
+
+// All the routes are drawn in one painter pass, layer by layer, so that the pen state changes once per layer and not once per route.
+void Renderer::renderRoutes()
+{
+	std::vector<Route>& routes = routeManager->getRoutes();
+	Route& route = routeManager->getDefaultRoute();
+
+	painter->begin(paintTarget);
+	painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform | QPainter::HighQualityAntialiasing);
+
+	if (renderMode != RenderMode::Map)
+	{
+		painter->setClipping(true);
+		painter->setClipRect(0, 0, (int)(mapPanel.relativeWidth * windowWidth + 0.5), (int)windowHeight);
+	}
+
+	painter->setWorldMatrix(getRouteMatrix());
+
+	if (route.routeRenderMode == RouteRenderMode::Discreet || route.routeRenderMode == RouteRenderMode::Highlight)
+	{
+		QPen routePen;
+		routePen.setWidthF(route.routeWidth * route.userScale);
+		routePen.setJoinStyle(Qt::PenJoinStyle::RoundJoin);
+		routePen.setCapStyle(Qt::PenCapStyle::RoundCap);
+		routePen.setColor(route.routeRenderMode == RouteRenderMode::Discreet ? route.discreetColor : route.highlightColor);
+
+		painter->setPen(routePen);
+		painter->setBrush(Qt::NoBrush);
+		painter->drawPath(route.routePath);
+	}
+
+	if (route.routeRenderMode == RouteRenderMode::Pace)
+	{
+		QPen paceRoutePen;
+		paceRoutePen.setWidthF(route.routeWidth * route.userScale);
+		paceRoutePen.setCapStyle(Qt::PenCapStyle::RoundCap);
+
+		for (int i = 0; i < (int)route.routePoints.size() - 1; ++i)
+		{
+			RoutePoint& rp1 = route.routePoints.at(i);
+			RoutePoint& rp2 = route.routePoints.at(i + 1);
+
+			if (rp1.segmentIndex != rp2.segmentIndex)
+				continue;
+
+			paceRoutePen.setColor(rp2.color);
+
+			painter->setPen(paceRoutePen);
+			painter->setBrush(Qt::NoBrush);
+			painter->drawLine(rp1.position, rp2.position);
+		}
+	}
+
+	if (route.tailRenderMode == RouteRenderMode::Discreet || route.tailRenderMode == RouteRenderMode::Highlight)
+	{
+		QPen tailPen;
+		tailPen.setWidthF(route.tailWidth * route.userScale);
+		tailPen.setJoinStyle(Qt::PenJoinStyle::RoundJoin);
+		tailPen.setCapStyle(Qt::PenCapStyle::RoundCap);
+		painter->setBrush(Qt::NoBrush);
+
+		// the default route is drawn last, on top of the others
+		for (int i = (int)routes.size() - 1; i >= 0; --i)
+		{
+			Route& tailRoute = routes.at(i);
+
+			if (tailRoute.tailRenderMode == RouteRenderMode::None)
+				continue;
+
+			tailPen.setColor(tailRoute.tailRenderMode == RouteRenderMode::Discreet ? tailRoute.discreetColor : tailRoute.highlightColor);
+			painter->setPen(tailPen);
+
+			renderTail(tailRoute);
+		}
+	}
+
+	if (route.showControls)
+	{
+		QPen controlPen;
+		controlPen.setWidthF(route.controlBorderWidth * route.userScale);
+		controlPen.setColor(route.controlBorderColor);
+
+		double controlRadius = route.controlRadius * route.userScale;
+
+		painter->setPen(controlPen);
+		painter->setBrush(Qt::NoBrush);
+
+		for (const QPointF& controlPosition : route.controlPositions)
+			painter->drawEllipse(controlPosition, controlRadius, controlRadius);
+	}
+
+	if (route.showRunner)
+	{
+		QPen runnerPen;
+		QBrush runnerBrush;
+		runnerPen.setWidthF(route.runnerBorderWidth * route.userScale);
+		runnerPen.setColor(route.runnerBorderColor);
+		runnerBrush.setStyle(Qt::SolidPattern);
+
+		double runnerRadius = route.runnerRadius * route.runnerScale * route.userScale;
+
+		painter->setPen(runnerPen);
+
+		for (int i = (int)routes.size() - 1; i >= 0; --i)
+		{
+			runnerBrush.setColor(routes.at(i).runnerColor);
+
+			painter->setBrush(runnerBrush);
+			painter->drawEllipse(routes.at(i).runnerPosition, runnerRadius, runnerRadius);
+		}
+	}
+
+	painter->setClipping(false);
+	painter->end();
+}
+
+// The tail is split at the segment starts, a piece needs at least two vertices.
+void Renderer::renderTail(const Route& route)
+{
+	const std::vector<int>& segmentStartIndices = route.track.segmentStartIndices;
+	auto segmentStart = std::upper_bound(segmentStartIndices.begin(), segmentStartIndices.end(), route.tailFirstIndex);
+	int pieceFirstIndex = route.tailFirstIndex;
+
+	while (pieceFirstIndex < route.tailLastIndex)
+	{
+		int pieceLastIndex = route.tailLastIndex;
+
+		if (segmentStart != segmentStartIndices.end() && *segmentStart <= route.tailLastIndex)
+			pieceLastIndex = *segmentStart - 1;
+
+		if (pieceLastIndex > pieceFirstIndex)
+			painter->drawPolyline(&route.tailVertices[pieceFirstIndex], pieceLastIndex - pieceFirstIndex + 1);
+
+		if (pieceLastIndex == route.tailLastIndex)
+			break;
+
+		pieceFirstIndex = *segmentStart++;
+	}
+}
+
+void Renderer::renderInfoPanel()
+{
+	InfoPanelValues values;
+	values.scrollMode = (int)inputHandler->getScrollMode();
+	values.videoScale = videoPanel.userScale;
+	values.mapScale = mapPanel.userScale;
+	values.routeScale = routeManager->getDefaultRoute().userScale;
+	values.controlTimeOffset = routeManager->getDefaultRoute().controlTimeOffset;
+	values.runnerTimeOffset = routeManager->getDefaultRoute().runnerTimeOffset;
+
+	// when encoding, refresh according to the video time so that the output does not depend on the encoding speed
+	double refreshTime = renderToOffscreen ? currentTime : infoPanelRefreshTimer.nsecsElapsed() / 1000000000.0;
+	bool refreshIntervalElapsed = (infoPanelRefreshRate <= 0.0) || (std::abs(refreshTime - previousInfoPanelRefreshTime) >= (1.0 / infoPanelRefreshRate));
+
+	if (infoPanelRefreshRequested || refreshIntervalElapsed || values != previousInfoPanelValues)
+	{
+		updateInfoPanelImage();
+
+		if (!useCpuRenderer)
+		{
+			QOpenGLPixelTransferOptions options;
+			options.setRowLength(infoPanelImage.bytesPerLine() / 4);
+			options.setImageHeight(infoPanelImage.height());
+			options.setAlignment(1);
+
+			// ARGB32 is stored as BGRA bytes on little endian machines
+			infoPanel.texture.setData(QOpenGLTexture::BGRA, QOpenGLTexture::UInt8, infoPanelImage.constBits(), &options);
+		}
+
+		previousInfoPanelValues = values;
+		previousInfoPanelRefreshTime = refreshTime;
+		infoPanelRefreshRequested = false;
+	}
+
+	if (useCpuRenderer)
+	{
+		painter->begin(paintTarget);
+		painter->drawImage(0, 0, infoPanelImage);
+		painter->end();
+
+		return;
+	}
+
+	infoPanel.vertexMatrix.setToIdentity();
+
+	if (!renderToOffscreen)
+		infoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, -windowHeight / 2, windowHeight / 2, 0.0f, 1.0f);
+	else
+		infoPanel.vertexMatrix.ortho(-windowWidth / 2, windowWidth / 2, windowHeight / 2, -windowHeight / 2, 0.0f, 1.0f);
+
+	// anchor the panel to the top left corner of the window
+	infoPanel.vertexMatrix.translate(-windowWidth / 2.0 + infoPanel.textureWidth / 2.0, windowHeight / 2.0 - infoPanel.textureHeight / 2.0);
+
+	// the image has premultiplied alpha
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	renderPanel(infoPanel);
+
+	glDisable(GL_BLEND);
+}
+
+void Renderer::updateInfoPanelImage()
+{
+	QFontMetrics metrics(infoPanelFont);
+
+	int textX = 10;
+	int textY = 6;
+	int lineHeight = metrics.height();
+	int lineSpacing = metrics.lineSpacing() + 1;
+	int lineWidth1 = metrics.boundingRect("control offset:").width();
+	int lineWidth2 = metrics.boundingRect("99:99:99.999").width();
+	int rightPartMargin = 15;
+	int backgroundRadius = 10;
+	int backgroundWidth = infoPanelImage.width() + backgroundRadius - 1;
+	int backgroundHeight = infoPanelImage.height() + backgroundRadius - 1;
+
+	QColor textColor = QColor(255, 255, 255, 200);
+	QColor textGreenColor = QColor(0, 255, 0, 200);
+	QColor textRedColor = QColor(255, 0, 0, 200);
+
+	infoPanelImage.fill(Qt::transparent);
+
+	QPainter painter(&infoPanelImage);
+	painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform | QPainter::HighQualityAntialiasing);
+
+	painter.setPen(QColor(0, 0, 0));
+	painter.setBrush(QBrush(QColor(20, 20, 20, 220)));
+	painter.drawRoundedRect(-backgroundRadius, -backgroundRadius, backgroundWidth, backgroundHeight, backgroundRadius, backgroundRadius);
+
+	painter.setPen(textColor);
+	painter.setFont(infoPanelFont);
+
+	painter.drawText(textX, textY, lineWidth1, lineHeight, 0, "time:");
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "fps:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "frame:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "decode:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "stabilize:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "render:");
+
+	if (renderToOffscreen)
+		painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "encode:");
+	else
+	{
+		painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "spare:");
+		painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "drift:");
+		painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "missed:");
+	}
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "scroll:");
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "video scale:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "map scale:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "route scale:");
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "control offset:");
+	painter.drawText(textX, textY += lineSpacing, lineWidth1, lineHeight, 0, "runner offset:");
+
+	textX += lineWidth1 + rightPartMargin;
+	textY = 6;
+
+	QTime currentTimeTemp = QTime(0, 0, 0, 0).addMSecs((int)(currentTime * 1000.0 + 0.5));
+	painter.drawText(textX, textY, lineWidth2, lineHeight, 0, currentTimeTemp.toString("HH:mm:ss.zzz"));
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(averageFps.getAverage(), 'f', 2));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageFrameDuration.getAverage(), 'f', 2)));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageDecodeDuration.getAverage(), 'f', 2)));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageStabilizeDuration.getAverage(), 'f', 2)));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageRenderDuration.getAverage(), 'f', 2)));
+
+	if (renderToOffscreen)
+		painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageEncodeDuration.getAverage(), 'f', 2)));
+	else
+	{
+		if (averageSpareTime.getAverage() < 0)
+			painter.setPen(textRedColor);
+		else if (averageSpareTime.getAverage() > 0)
+			painter.setPen(textGreenColor);
+
+		painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(averageSpareTime.getAverage(), 'f', 2)));
+		painter.setPen(textColor);
+
+		painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 ms").arg(QString::number(framePacingDrift, 'f', 2)));
+
+		if (missedFrameCount > 0 || resynchronizationCount > 0)
+			painter.setPen(textRedColor);
+
+		painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 / %2").arg(missedFrameCount).arg(resynchronizationCount));
+		painter.setPen(textColor);
+	}
+
+	QString scrollText;
+
+	switch (inputHandler->getScrollMode())
+	{
+		case ScrollMode::None: scrollText = "none (seek)"; break;
+		case ScrollMode::Map: scrollText = "map"; break;
+		case ScrollMode::Video: scrollText = "video"; break;
+		default: scrollText = "unknown"; break;
+	}
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, scrollText);
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(videoPanel.userScale, 'f', 2));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(mapPanel.userScale, 'f', 2));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString::number(routeManager->getDefaultRoute().userScale, 'f', 2));
+
+	textY += lineSpacing;
+
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 s").arg(QString::number(routeManager->getDefaultRoute().controlTimeOffset, 'f', 2)));
+	painter.drawText(textX, textY += lineSpacing, lineWidth2, lineHeight, 0, QString("%1 s").arg(QString::number(routeManager->getDefaultRoute().runnerTimeOffset, 'f', 2)));
+}
+
+Panel& Renderer::getVideoPanel()
+{
+	return videoPanel;
+}
+
+Panel& Renderer::getMapPanel()
+{
+	return mapPanel;
+}
+
+// Returns false if the window position is not on the map panel.
+bool Renderer::getRoutePosition(const QPointF& windowPosition, QPointF& routePosition) const
+{
+	if (renderMode == RenderMode::Video)
+		return false;
+
+	if (renderMode != RenderMode::Map && windowPosition.x() >= mapPanel.relativeWidth * windowWidth)
+		return false;
+
+	bool isInvertible = false;
+	QMatrix inverseRouteMatrix = getRouteMatrix().inverted(&isInvertible);
+
+	if (!isInvertible)
+		return false;
+
+	routePosition = inverseRouteMatrix.map(windowPosition);
+
+	return true;
+}
+
+RenderMode Renderer::getRenderMode() const
+{
+	return renderMode;
+}
+
+double Renderer::getRenderDuration() const
+{
+	return renderDuration;
+}
+
+bool Renderer::getIsDirty() const
+{
+	return isDirty;
+}
+
+void Renderer::setRenderMode(RenderMode mode)
+{
+	renderMode = mode;
+	isDirty = true;
+}
+
+// Missed frames were presented at least one frame late, resynchronizations dropped the video clock altogether.
+void Renderer::setFramePacingStatistics(double averageDrift, int missedFrameCount, int resynchronizationCount)
+{
+	this->framePacingDrift = averageDrift;
+	this->missedFrameCount = missedFrameCount;
+	this->resynchronizationCount = resynchronizationCount;
+}
+
+void Renderer::toggleShowInfoPanel()
+{
+	showInfoPanel = !showInfoPanel;
+	infoPanelRefreshRequested = true;
+	isDirty = true;
+}
+
+void Renderer::requestFullClear()
+{
+	fullClearRequested = true;
+	isDirty = true;
+}
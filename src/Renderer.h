@@ -1,134 +1,220 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QElapsedTimer>
-#include <QOpenGLFunctions>
-#include <QOpenGLShaderProgram>
-#include <QOpenGLVertexArrayObject>
-#include <QOpenGLBuffer>
-#include <QOpenGLTexture>
-#include <QOpenGLFramebufferObject>
-#include <QOpenGLPaintDevice>
-#include <QPainter>
-
-#include "MovingAverage.h"
-#include "FrameData.h"
-
-namespace OrientView
-{
-	class VideoDecoder;
-	class MapImageReader;
-	class VideoStabilizer;
-	class InputHandler;
-	class RouteManager;
-	class Settings;
-	struct Route;
-
-	enum RenderMode { All, Map, Video };
-
-	struct Panel
-	{
-		Panel();
-
-		QOpenGLShaderProgram shaderProgram;
-		QOpenGLVertexArrayObject vertexArrayObject;
-		QOpenGLBuffer vertexBuffer;
-		QOpenGLTexture texture;
-
-		QMatrix4x4 vertexMatrix;
-
-		QColor clearColor = QColor(0, 0, 0);
-		bool clippingEnabled = true;
-		bool clearingEnabled = true;
-
-		double x = 0.0;
-		double y = 0.0;
-		double angle = 0.0;
-		double scale = 1.0;
-		double userX = 0.0;
-		double userY = 0.0;
-		double userAngle = 0.0;
-		double userScale = 1.0;
-		double offsetX = 0.0;
-		double offsetY = 0.0;
-
-		double textureWidth = 0.0;
-		double textureHeight = 0.0;
-		double texelWidth = 0.0;
-		double texelHeight = 0.0;
-
-		double relativeWidth = 1.0;
-	};
-
-	// Does the actual drawing using OpenGL.
-	class Renderer : protected QOpenGLFunctions
-	{
-
-	public:
-
-		bool initialize(VideoDecoder* videoDecoder, MapImageReader* mapImageReader, VideoStabilizer* videoStabilizer, InputHandler* inputHandler, RouteManager* routeManager, Settings* settings, bool renderToOffscreen);
-		bool windowResized(int newWidth, int newHeight);
-		~Renderer();
-
-		void startRendering(double currentTime, double frameDuration, double decodeDuration, double stabilizeDuration, double encodeDuration, double spareTime);
-		void uploadFrameData(const FrameData& frameData);
-		void renderAll();
-		void stopRendering();
-
-		FrameData getRenderedFrame();
-		Panel& getVideoPanel();
-		Panel& getMapPanel();
-		RenderMode getRenderMode() const;
-
-		void setRenderMode(RenderMode mode);
-		void toggleShowInfoPanel();
-		void requestFullClear();
-
-	private:
-
-		bool loadRescaleShader(Panel& panel, const QString& shaderName);
-		void renderVideoPanel();
-		void renderMapPanel();
-		void renderPanel(Panel& panel);
-		void renderRoute(Route& route);
-		void renderInfoPanel();
-
-		VideoStabilizer* videoStabilizer = nullptr;
-		InputHandler* inputHandler = nullptr;
-		RouteManager* routeManager = nullptr;
-
-		bool renderToOffscreen = false;
-		bool showInfoPanel = false;
-		bool fullClearRequested = true;
-
-		double windowWidth = 0.0;
-		double windowHeight = 0.0;
-		double currentTime = 0.0;
-		int multisamples = 0;
-		int infoPanelFontSize = 0;
-
-		Panel videoPanel;
-		Panel mapPanel;
-		RenderMode renderMode = RenderMode::All;
-
-		QElapsedTimer renderDurationTimer;
-		double renderDuration = 0.0;
-
-		MovingAverage averageFps;
-		MovingAverage averageFrameDuration;
-		MovingAverage averageDecodeDuration;
-		MovingAverage averageStabilizeDuration;
-		MovingAverage averageRenderDuration;
-		MovingAverage averageEncodeDuration;
-		MovingAverage averageSpareTime;
-
-		QOpenGLPaintDevice* paintDevice = nullptr;
-		QPainter* painter = nullptr;
-
-		QOpenGLFramebufferObject* offscreenFramebuffer = nullptr;
-		QOpenGLFramebufferObject* offscreenFramebufferNonMultisample = nullptr;
-		FrameData renderedFrameData;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLBuffer>
+#include <QOpenGLTexture>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
+#include <QPainter>
+#include <QImage>
+#include <QTransform>
+#include <QMatrix>
+#include <QFont>
+
+#include "MovingAverage.h"
+#include "FrameData.h"
+
+namespace OrientView
+{
+	class VideoDecoder;
+	class MapImageReader;
+	class VideoStabilizer;
+	class InputHandler;
+	class RouteManager;
+	class Settings;
+	class CpuCompositor;
+	struct Route;
+	struct MapTile;
+
+	enum RenderMode { All, Map, Video };
+
+	struct Panel
+	{
+		Panel();
+
+		QOpenGLShaderProgram shaderProgram;
+		QOpenGLVertexArrayObject vertexArrayObject;
+		QOpenGLBuffer vertexBuffer;
+		QOpenGLTexture texture;
+
+		QMatrix4x4 vertexMatrix;
+
+		QColor clearColor = QColor(0, 0, 0);
+		bool clippingEnabled = true;
+		bool clearingEnabled = true;
+
+		double x = 0.0;
+		double y = 0.0;
+		double angle = 0.0;
+		double scale = 1.0;
+		double userX = 0.0;
+		double userY = 0.0;
+		double userAngle = 0.0;
+		double userScale = 1.0;
+		double offsetX = 0.0;
+		double offsetY = 0.0;
+
+		double textureWidth = 0.0;
+		double textureHeight = 0.0;
+		double texelWidth = 0.0;
+		double texelHeight = 0.0;
+
+		double relativeWidth = 1.0;
+
+		bool separableRescaling = false;
+		int interpolationFunction = 0;
+		QOpenGLFramebufferObject* horizontalFramebuffer = nullptr;
+		QOpenGLFramebufferObject* verticalFramebuffer = nullptr;
+	};
+
+	// A map tile uploaded to the GPU, released again when it has not been visible for a while and the tile cache is full.
+	struct MapTileTexture
+	{
+		QOpenGLTexture* texture = nullptr;
+		size_t size = 0; // bytes
+		int64_t lastUsedFrame = 0;
+	};
+
+	// The user controllable values shown in the info panel. A change in any of these forces a redraw of the panel.
+	struct InfoPanelValues
+	{
+		int scrollMode = 0;
+		double videoScale = 0.0;
+		double mapScale = 0.0;
+		double routeScale = 0.0;
+		double controlTimeOffset = 0.0;
+		double runnerTimeOffset = 0.0;
+
+		bool operator==(const InfoPanelValues& other) const;
+		bool operator!=(const InfoPanelValues& other) const;
+	};
+
+	// Does the actual drawing using OpenGL, or in software when encoding without an OpenGL context.
+	class Renderer : protected QOpenGLFunctions
+	{
+
+	public:
+
+		bool initialize(VideoDecoder* videoDecoder, MapImageReader* mapImageReader, VideoStabilizer* videoStabilizer, InputHandler* inputHandler, RouteManager* routeManager, Settings* settings, bool renderToOffscreen);
+		bool windowResized(int newWidth, int newHeight);
+		~Renderer();
+
+		void startRendering(double currentTime, double frameDuration, double decodeDuration, double stabilizeDuration, double encodeDuration, double spareTime);
+		void uploadFrameData(const FrameData& frameData);
+		void renderAll();
+		void stopRendering();
+
+		void getRenderedFrame(FrameData& frameData);
+		size_t getRenderedFrameLength() const;
+		Panel& getVideoPanel();
+		Panel& getMapPanel();
+		bool getRoutePosition(const QPointF& windowPosition, QPointF& routePosition) const;
+		RenderMode getRenderMode() const;
+		double getRenderDuration() const;
+		bool getIsDirty() const;
+
+		void setRenderMode(RenderMode mode);
+		void setFramePacingStatistics(double averageDrift, int missedFrameCount, int resynchronizationCount);
+		void toggleShowInfoPanel();
+		void requestFullClear();
+
+	private:
+
+		bool initializeInfoPanel();
+		bool loadRescaleShader(Panel& panel, const QString& shaderName);
+		bool loadPanelRescaleShader(Panel& panel, const QString& shaderName, const QString& interpolationFunction);
+		bool createInterpolationWeightTexture();
+		void renderSeparableRescale(Panel& panel);
+		void updateVideoPanelMatrix();
+		void updateMapPanelMatrix();
+		QRect getVideoPanelScissorRect() const;
+		void renderVideoPanel();
+		void renderVideoPanelOnCpu();
+		void renderMapPanel();
+		void renderMapPanelOnCpu();
+		void renderMapTiles();
+		int getMapTileLevel() const;
+		std::vector<int> getVisibleMapTiles(int level) const;
+		QRectF getMapTilePanelRect(const MapTile& tile) const;
+		QOpenGLTexture* getMapTileTexture(int level, int index);
+		void releaseMapTileTextures();
+		QTransform getPanelTransform(const Panel& panel, const QRectF& panelRect, const QRectF& sourceRect) const;
+		void renderPanel(Panel& panel);
+		QMatrix getRouteMatrix() const;
+		void renderRoutes();
+		void renderTail(const Route& route);
+		void renderInfoPanel();
+		void updateInfoPanelImage();
+
+		MapImageReader* mapImageReader = nullptr;
+		VideoStabilizer* videoStabilizer = nullptr;
+		InputHandler* inputHandler = nullptr;
+		RouteManager* routeManager = nullptr;
+
+		bool renderToOffscreen = false;
+		bool useCpuRenderer = false;
+		bool showInfoPanel = false;
+		bool fullClearRequested = true;
+		bool isDirty = true;
+
+		double windowWidth = 0.0;
+		double windowHeight = 0.0;
+		double currentTime = 0.0;
+		int multisamples = 0;
+		int maxTextureSize = 0;
+		int infoPanelFontSize = 0;
+		double infoPanelRefreshRate = 0.0;
+
+		Panel videoPanel;
+		Panel mapPanel;
+		Panel infoPanel;
+		Panel separableRescalePanel;
+		QOpenGLTexture* interpolationWeightTexture = nullptr;
+		std::vector<std::vector<MapTileTexture>> mapTileTextures;
+		size_t mapTileCacheSize = 0; // bytes
+		size_t mapTileCacheBudget = 0;
+		int64_t mapTileFrameIndex = 0;
+		QImage videoFrameImage;
+		CpuCompositor* cpuCompositor = nullptr;
+		RenderMode renderMode = RenderMode::All;
+
+		QElapsedTimer renderDurationTimer;
+		double renderDuration = 0.0;
+
+		MovingAverage averageFps;
+		MovingAverage averageFrameDuration;
+		MovingAverage averageDecodeDuration;
+		MovingAverage averageStabilizeDuration;
+		MovingAverage averageRenderDuration;
+		MovingAverage averageEncodeDuration;
+		MovingAverage averageSpareTime;
+
+		double framePacingDrift = 0.0;
+		int missedFrameCount = 0;
+		int resynchronizationCount = 0;
+
+		QFont infoPanelFont;
+		QImage infoPanelImage;
+		QElapsedTimer infoPanelRefreshTimer;
+		InfoPanelValues previousInfoPanelValues;
+		double previousInfoPanelRefreshTime = 0.0;
+		bool infoPanelRefreshRequested = true;
+
+		QOpenGLPaintDevice* paintDevice = nullptr;
+		QPaintDevice* paintTarget = nullptr;
+		QPainter* painter = nullptr;
+
+		QOpenGLFramebufferObject* offscreenFramebuffer = nullptr;
+		QOpenGLFramebufferObject* offscreenFramebufferNonMultisample = nullptr;
+		FrameData renderedFrameData;
+	};
+}
@@ -0,0 +1,255 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <cstdint>
+#include <cstring>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QCryptographicHash>
+
+#include "RouteCache.h"
+
+using namespace OrientView;
+
+namespace
+{
+	const char cacheMagic[8] = { 'O', 'V', 'R', 'O', 'U', 'T', 'E', 0 };
+	const uint32_t cacheVersion = 2;
+	const int sourceHashLength = 20; // SHA-1
+
+	// The header is followed by the arrays of the route points and then the arrays of the track, each padded to eight bytes.
+	// Everything is in the native byte order, so the file can be used straight from memory.
+	struct CacheHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;
+		uint8_t sourceHash[sourceHashLength];
+		int32_t mapWidth;
+		int32_t mapHeight;
+		int32_t sampleRate;
+		int32_t routePointCount;
+		int32_t trackSampleCount;
+		int32_t trackSegmentStartCount;
+	};
+
+	size_t paddedSize(size_t size)
+	{
+		return (size + 7) & ~(size_t)7;
+	}
+
+	template <typename T>
+	void appendArray(QByteArray& buffer, const std::vector<T>& values)
+	{
+		size_t size = values.size() * sizeof(T);
+
+		buffer.append((const char*)values.data(), (int)size);
+		buffer.append(QByteArray((int)(paddedSize(size) - size), 0));
+	}
+
+	// Returns false if the array would go past the end of the data.
+	template <typename T>
+	bool readArray(const uchar*& data, const uchar* dataEnd, std::vector<T>& values, int count)
+	{
+		size_t size = (size_t)count * sizeof(T);
+
+		if ((size_t)(dataEnd - data) < paddedSize(size))
+			return false;
+
+		values.resize((size_t)count);
+		memcpy(values.data(), data, size);
+		data += paddedSize(size);
+
+		return true;
+	}
+}
+
+// The cache is keyed by the contents of the route file, its calibration, and the settings the processing depends on.
+bool RouteCache::initialize(const QString& sourceFilePath, const uint8_t* sourceData, size_t sourceSize, const QString& calibration, int mapWidth, int mapHeight, int sampleRate)
+{
+	this->mapWidth = mapWidth;
+	this->mapHeight = mapHeight;
+	this->sampleRate = sampleRate;
+
+	cacheFilePath = sourceFilePath + ".cache";
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData((const char*)sourceData, (int)sourceSize);
+	hash.addData(calibration.toUtf8());
+	sourceHash = hash.result();
+
+	return true;
+}
+
+// Returns false if there is no cache file or if it was written for a different route file or different settings.
+bool RouteCache::read(std::vector<RoutePoint>& routePoints, RouteTrack& track)
+{
+	if (sourceHash.size() != sourceHashLength)
+		return false;
+
+	QFile file(cacheFilePath);
+
+	if (!file.exists() || !file.open(QIODevice::ReadOnly) || file.size() < (qint64)sizeof(CacheHeader))
+		return false;
+
+	const uchar* data = file.map(0, file.size());
+
+	if (data == nullptr)
+	{
+		qWarning("Could not map the route cache file");
+		return false;
+	}
+
+	const uchar* dataEnd = data + file.size();
+	CacheHeader header;
+	memcpy(&header, data, sizeof(CacheHeader));
+
+	if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+		header.version != cacheVersion ||
+		header.headerSize != sizeof(CacheHeader) ||
+		memcmp(header.sourceHash, sourceHash.constData(), sourceHashLength) != 0 ||
+		header.mapWidth != mapWidth ||
+		header.mapHeight != mapHeight ||
+		header.sampleRate != sampleRate ||
+		header.routePointCount < 0 ||
+		header.trackSampleCount < 0 ||
+		header.trackSegmentStartCount < 0)
+	{
+		qDebug("Route cache is out of date");
+		return false;
+	}
+
+	data += paddedSize(sizeof(CacheHeader));
+
+	int count = header.routePointCount;
+	std::vector<int64_t> dateTimes;
+	std::vector<double> times, longitudes, latitudes, positionXs, positionYs, elevations, heartRates, paces, orientations;
+	std::vector<int32_t> segmentIndices;
+
+	if (!readArray(data, dataEnd, dateTimes, count) ||
+		!readArray(data, dataEnd, times, count) ||
+		!readArray(data, dataEnd, longitudes, count) ||
+		!readArray(data, dataEnd, latitudes, count) ||
+		!readArray(data, dataEnd, positionXs, count) ||
+		!readArray(data, dataEnd, positionYs, count) ||
+		!readArray(data, dataEnd, elevations, count) ||
+		!readArray(data, dataEnd, heartRates, count) ||
+		!readArray(data, dataEnd, paces, count) ||
+		!readArray(data, dataEnd, orientations, count) ||
+		!readArray(data, dataEnd, segmentIndices, count))
+	{
+		qWarning("Route cache file is truncated");
+		return false;
+	}
+
+	RouteTrack tempTrack;
+	count = header.trackSampleCount;
+
+	if (!readArray(data, dataEnd, tempTrack.x, count) ||
+		!readArray(data, dataEnd, tempTrack.y, count) ||
+		!readArray(data, dataEnd, tempTrack.elevation, count) ||
+		!readArray(data, dataEnd, tempTrack.heartRate, count) ||
+		!readArray(data, dataEnd, tempTrack.pace, count) ||
+		!readArray(data, dataEnd, tempTrack.orientation, count) ||
+		!readArray(data, dataEnd, tempTrack.segmentStartIndices, header.trackSegmentStartCount))
+	{
+		qWarning("Route cache file is truncated");
+		return false;
+	}
+
+	routePoints.clear();
+	routePoints.resize((size_t)header.routePointCount);
+
+	for (size_t i = 0; i < routePoints.size(); ++i)
+	{
+		RoutePoint& rp = routePoints[i];
+
+		rp.dateTime = QDateTime::fromMSecsSinceEpoch(dateTimes[i]);
+		rp.time = times[i];
+		rp.coordinate = QPointF(longitudes[i], latitudes[i]);
+		rp.position = QPointF(positionXs[i], positionYs[i]);
+		rp.elevation = elevations[i];
+		rp.heartRate = heartRates[i];
+		rp.pace = paces[i];
+		rp.orientation = orientations[i];
+		rp.segmentIndex = segmentIndices[i];
+	}
+
+	track = tempTrack;
+
+	return true;
+}
+
+// The file is replaced atomically, so an interrupted write does not leave a broken cache behind.
+bool RouteCache::write(const std::vector<RoutePoint>& routePoints, const RouteTrack& track)
+{
+	if (sourceHash.size() != sourceHashLength)
+		return false;
+
+	CacheHeader header;
+	memset(&header, 0, sizeof(CacheHeader));
+	memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	memcpy(header.sourceHash, sourceHash.constData(), sourceHashLength);
+	header.version = cacheVersion;
+	header.headerSize = sizeof(CacheHeader);
+	header.mapWidth = mapWidth;
+	header.mapHeight = mapHeight;
+	header.sampleRate = sampleRate;
+	header.routePointCount = (int32_t)routePoints.size();
+	header.trackSampleCount = track.getSize();
+	header.trackSegmentStartCount = (int32_t)track.segmentStartIndices.size();
+
+	std::vector<int64_t> dateTimes;
+	std::vector<double> times, longitudes, latitudes, positionXs, positionYs, elevations, heartRates, paces, orientations;
+	std::vector<int32_t> segmentIndices;
+
+	for (const RoutePoint& rp : routePoints)
+	{
+		dateTimes.push_back(rp.dateTime.toMSecsSinceEpoch());
+		times.push_back(rp.time);
+		longitudes.push_back(rp.coordinate.x());
+		latitudes.push_back(rp.coordinate.y());
+		positionXs.push_back(rp.position.x());
+		positionYs.push_back(rp.position.y());
+		elevations.push_back(rp.elevation);
+		heartRates.push_back(rp.heartRate);
+		paces.push_back(rp.pace);
+		orientations.push_back(rp.orientation);
+		segmentIndices.push_back(rp.segmentIndex);
+	}
+
+	QByteArray buffer;
+	buffer.append((const char*)&header, (int)sizeof(CacheHeader));
+	buffer.append(QByteArray((int)(paddedSize(sizeof(CacheHeader)) - sizeof(CacheHeader)), 0));
+
+	appendArray(buffer, dateTimes);
+	appendArray(buffer, times);
+	appendArray(buffer, longitudes);
+	appendArray(buffer, latitudes);
+	appendArray(buffer, positionXs);
+	appendArray(buffer, positionYs);
+	appendArray(buffer, elevations);
+	appendArray(buffer, heartRates);
+	appendArray(buffer, paces);
+	appendArray(buffer, orientations);
+	appendArray(buffer, segmentIndices);
+
+	appendArray(buffer, track.x);
+	appendArray(buffer, track.y);
+	appendArray(buffer, track.elevation);
+	appendArray(buffer, track.heartRate);
+	appendArray(buffer, track.pace);
+	appendArray(buffer, track.orientation);
+	appendArray(buffer, track.segmentStartIndices);
+
+	QSaveFile file(cacheFilePath);
+
+	if (!file.open(QIODevice::WriteOnly) || file.write(buffer) != buffer.size() || !file.commit())
+	{
+		qWarning("Could not write the route cache file %s", qPrintable(cacheFilePath));
+		return false;
+	}
+
+	return true;
+}
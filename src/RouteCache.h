@@ -0,0 +1,36 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+#include <QByteArray>
+
+#include "RoutePoint.h"
+#include "RouteTrack.h"
+
+namespace OrientView
+{
+	// Store the processed route in a binary file next to the route file, so that later runs can skip parsing and processing it.
+	class RouteCache
+	{
+
+	public:
+
+		bool initialize(const QString& sourceFilePath, const uint8_t* sourceData, size_t sourceSize, const QString& calibration, int mapWidth, int mapHeight, int sampleRate);
+
+		bool read(std::vector<RoutePoint>& routePoints, RouteTrack& track);
+		bool write(const std::vector<RoutePoint>& routePoints, const RouteTrack& track);
+
+	private:
+
+		QString cacheFilePath;
+		QByteArray sourceHash;
+		int mapWidth = 0;
+		int mapHeight = 0;
+		int sampleRate = 1;
+	};
+}
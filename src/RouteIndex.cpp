@@ -0,0 +1,173 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "RouteIndex.h"
+
+using namespace OrientView;
+
+namespace
+{
+	const double samplesPerCell = 4.0;
+	const int maxCellsPerSide = 2048;
+}
+
+// The entries are sorted by cell with a counting sort, so that the samples of one cell are next to each other in memory.
+void RouteIndex::initialize(const std::vector<const RouteTrack*>& tracks)
+{
+	cellStarts.clear();
+	entries.clear();
+	columnCount = 0;
+	rowCount = 0;
+
+	size_t sampleCount = 0;
+
+	minX = std::numeric_limits<double>::max();
+	minY = std::numeric_limits<double>::max();
+	maxX = -std::numeric_limits<double>::max();
+	maxY = -std::numeric_limits<double>::max();
+
+	for (const RouteTrack* track : tracks)
+	{
+		for (int i = 0; i < track->getSize(); ++i)
+		{
+			minX = std::min(minX, track->x[i]);
+			minY = std::min(minY, track->y[i]);
+			maxX = std::max(maxX, track->x[i]);
+			maxY = std::max(maxY, track->y[i]);
+		}
+
+		sampleCount += (size_t)track->getSize();
+	}
+
+	if (sampleCount == 0)
+		return;
+
+	double width = std::max(maxX - minX, 1.0);
+	double height = std::max(maxY - minY, 1.0);
+
+	cellSize = sqrt(width * height * samplesPerCell / (double)sampleCount);
+	cellSize = std::max(cellSize, std::max(width, height) / maxCellsPerSide);
+
+	columnCount = std::max(1, (int)ceil(width / cellSize));
+	rowCount = std::max(1, (int)ceil(height / cellSize));
+
+	std::vector<int> sampleCells;
+	sampleCells.reserve(sampleCount);
+	cellStarts.assign((size_t)columnCount * rowCount + 1, 0);
+
+	for (const RouteTrack* track : tracks)
+	{
+		for (int i = 0; i < track->getSize(); ++i)
+		{
+			int cell = getRow(track->y[i]) * columnCount + getColumn(track->x[i]);
+
+			sampleCells.push_back(cell);
+			cellStarts[cell + 1]++;
+		}
+	}
+
+	for (size_t i = 1; i < cellStarts.size(); ++i)
+		cellStarts[i] += cellStarts[i - 1];
+
+	std::vector<int> cellPositions(cellStarts.begin(), cellStarts.end() - 1);
+	entries.resize(sampleCount);
+	size_t sampleIndex = 0;
+
+	for (int t = 0; t < (int)tracks.size(); ++t)
+	{
+		for (int i = 0; i < tracks[t]->getSize(); ++i)
+		{
+			Entry& entry = entries[cellPositions[sampleCells[sampleIndex++]]++];
+
+			entry.x = tracks[t]->x[i];
+			entry.y = tracks[t]->y[i];
+			entry.trackIndex = t;
+			entry.sampleIndex = i;
+		}
+	}
+}
+
+// Searches the cells in growing square rings around the position, until the ring is further away than the nearest sample found so far.
+// A position outside the grid is first moved to its edge, which does not bring any of the samples closer.
+bool RouteIndex::findNearestSample(const QPointF& position, double maxDistance, int& trackIndex, int& sampleIndex) const
+{
+	if (entries.empty())
+		return false;
+
+	double centerX = std::max(minX, std::min(position.x(), maxX));
+	double centerY = std::max(minY, std::min(position.y(), maxY));
+	double offsetX = position.x() - centerX;
+	double offsetY = position.y() - centerY;
+
+	if (offsetX * offsetX + offsetY * offsetY > maxDistance * maxDistance)
+		return false;
+
+	int centerColumn = getColumn(centerX);
+	int centerRow = getRow(centerY);
+	int maxRing = std::max(columnCount, rowCount);
+	double nearestDistanceSquared = maxDistance * maxDistance;
+	const Entry* nearestEntry = nullptr;
+
+	for (int ring = 0; ring <= maxRing; ++ring)
+	{
+		double ringDistance = (ring - 1) * cellSize;
+
+		if (ring > 1 && ringDistance * ringDistance > nearestDistanceSquared)
+			break;
+
+		for (int row = centerRow - ring; row <= centerRow + ring; ++row)
+		{
+			if (row < 0 || row >= rowCount)
+				continue;
+
+			// only the edges of the ring, the inside has already been searched
+			bool isEdgeRow = (row == centerRow - ring || row == centerRow + ring);
+			int columnStep = isEdgeRow ? 1 : std::max(1, 2 * ring);
+
+			for (int column = centerColumn - ring; column <= centerColumn + ring; column += columnStep)
+			{
+				if (column < 0 || column >= columnCount)
+					continue;
+
+				int cell = row * columnCount + column;
+
+				for (int i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i)
+				{
+					const Entry& entry = entries[i];
+
+					double dx = entry.x - position.x();
+					double dy = entry.y - position.y();
+					double distanceSquared = dx * dx + dy * dy;
+
+					if (distanceSquared < nearestDistanceSquared)
+					{
+						nearestDistanceSquared = distanceSquared;
+						nearestEntry = &entry;
+					}
+				}
+			}
+		}
+	}
+
+	if (nearestEntry == nullptr)
+		return false;
+
+	trackIndex = nearestEntry->trackIndex;
+	sampleIndex = nearestEntry->sampleIndex;
+
+	return true;
+}
+
+int RouteIndex::getColumn(double x) const
+{
+	return std::max(0, std::min((int)((x - minX) / cellSize), columnCount - 1));
+}
+
+int RouteIndex::getRow(double y) const
+{
+	return std::max(0, std::min((int)((y - minY) / cellSize), rowCount - 1));
+}
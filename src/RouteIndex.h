@@ -0,0 +1,47 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include <QPointF>
+
+#include "RouteTrack.h"
+
+namespace OrientView
+{
+	// Uniform grid over the track samples of all the routes, for finding the sample nearest to a map position without going through the whole routes.
+	class RouteIndex
+	{
+
+	public:
+
+		void initialize(const std::vector<const RouteTrack*>& tracks);
+		bool findNearestSample(const QPointF& position, double maxDistance, int& trackIndex, int& sampleIndex) const;
+
+	private:
+
+		struct Entry
+		{
+			double x = 0.0;
+			double y = 0.0;
+			int trackIndex = 0;
+			int sampleIndex = 0;
+		};
+
+		int getColumn(double x) const;
+		int getRow(double y) const;
+
+		double minX = 0.0;
+		double minY = 0.0;
+		double maxX = 0.0;
+		double maxY = 0.0;
+		double cellSize = 1.0;
+		int columnCount = 0;
+		int rowCount = 0;
+
+		std::vector<int> cellStarts; // the entries of cell i are in [cellStarts[i], cellStarts[i + 1])
+		std::vector<Entry> entries;
+	};
+}
@@ -1,554 +1,720 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#define _USE_MATH_DEFINES
-#include <cmath>
-
-#include "RouteManager.h"
-#include "QuickRouteReader.h"
-#include "Renderer.h"
-#include "Settings.h"
-
-using namespace OrientView;
-
-bool RouteManager::initialize(QuickRouteReader* quickRouteReader, SplitsManager* splitsManager, Renderer* renderer, Settings* settings)
-{
-	this->renderer = renderer;
-
-	viewMode = settings->routeManager.viewMode;
-	useSmoothSplitTransition = settings->routeManager.useSmoothSplitTransition;
-	smoothSplitTransitionSpeed = settings->routeManager.smoothSplitTransitionSpeed;
-	topBottomMargin = settings->routeManager.topBottomMargin;
-	leftRightMargin = settings->routeManager.leftRightMargin;
-	maximumAutomaticZoom = settings->routeManager.maximumAutomaticZoom;
-	runnerAveragingFactor = settings->routeManager.runnerAveragingFactor;
-	runnerVerticalOffset = settings->routeManager.runnerVerticalOffset;
-	windowWidth = settings->window.width;
-	windowHeight = settings->window.height;
-
-	runnerAverageX.setAlpha(runnerAveragingFactor / 1000.0);
-	runnerAverageY.setAlpha(runnerAveragingFactor / 1000.0);
-	runnerAverageAngle.setAlpha(runnerAveragingFactor / 1000.0);
-
-	routes.push_back(Route());
-	Route& defaultRoute = routes.at(0);
-
-	defaultRoute.routePoints = quickRouteReader->getRoutePoints();
-	defaultRoute.runnerInfo = splitsManager->getDefaultRunnerInfo();
-	defaultRoute.discreetColor = settings->route.discreetColor;
-	defaultRoute.highlightColor = settings->route.highlightColor;
-	defaultRoute.routeRenderMode = settings->route.routeRenderMode;
-	defaultRoute.routeWidth = settings->route.routeWidth;
-	defaultRoute.tailRenderMode = settings->route.tailRenderMode;
-	defaultRoute.tailWidth = settings->route.tailWidth;
-	defaultRoute.tailLength = settings->route.tailLength;
-	defaultRoute.controlBorderColor = settings->route.controlBorderColor;
-	defaultRoute.controlRadius = settings->route.controlRadius;
-	defaultRoute.controlBorderWidth = settings->route.controlBorderWidth;
-	defaultRoute.showControls = settings->route.showControls;
-	defaultRoute.runnerColor = settings->route.runnerColor;
-	defaultRoute.runnerBorderColor = settings->route.runnerBorderColor;
-	defaultRoute.runnerRadius = settings->route.runnerRadius;
-	defaultRoute.runnerBorderWidth = settings->route.runnerBorderWidth;
-	defaultRoute.runnerScale = settings->route.runnerScale;
-	defaultRoute.showRunner = settings->route.showRunner;
-	defaultRoute.controlTimeOffset = settings->route.controlTimeOffset;
-	defaultRoute.runnerTimeOffset = settings->route.runnerTimeOffset;
-	defaultRoute.userScale = settings->route.scale;
-	defaultRoute.lowPace = settings->route.lowPace;
-	defaultRoute.highPace = settings->route.highPace;
-
-	for (Route& route : routes)
-	{
-		calculateAlignedRoutePoints(route);
-		calculateRoutePointColors(route);
-		calculateRoutePath(route);
-	}
-
-	update(0.0, 0.0);
-
-	if (viewMode == ViewMode::FixedSplit && currentSplitTransformationIndex == -1 && defaultRoute.splitTransformations.size() > 0)
-	{
-		currentSt = defaultRoute.splitTransformations.at(0);
-		currentSplitTransformationIndex = 0;
-	}
-
-	return true;
-}
-
-void RouteManager::update(double currentTime, double frameTime)
-{
-	if (fullUpdateRequested)
-	{
-		for (Route& route : routes)
-		{
-			calculateControlPositions(route);
-			calculateSplitTransformations(route);
-		}
-
-		fullUpdateRequested = false;
-	}
-
-	for (Route& route : routes)
-	{
-		calculateCurrentRunnerPosition(route, currentTime);
-		calculateTailPath(route, currentTime);
-	}
-
-	calculateCurrentSplitTransformation(routes.at(0), currentTime, frameTime);
-}
-
-void RouteManager::calculateAlignedRoutePoints(Route& route)
-{
-	if (route.routePoints.size() < 2)
-		return;
-
-	double alignedTime = 0.0;
-	RoutePoint currentRoutePoint = route.routePoints.at(0);
-	RoutePoint alignedRoutePoint;
-
-	// align and interpolate route point data to one second intervals
-	for (int i = 0; i < (int)route.routePoints.size() - 1;)
-	{
-		int nextIndex = 0;
-
-		for (int j = i + 1; j < (int)route.routePoints.size(); ++j)
-		{
-			if (route.routePoints.at(j).time - currentRoutePoint.time > 1.0)
-			{
-				nextIndex = j;
-				break;
-			}
-		}
-
-		if (nextIndex <= i)
-			break;
-
-		i = nextIndex;
-
-		RoutePoint nextRoutePoint = route.routePoints.at(nextIndex);
-
-		alignedRoutePoint.dateTime = currentRoutePoint.dateTime;
-		alignedRoutePoint.coordinate = currentRoutePoint.coordinate;
-
-		double timeDelta = nextRoutePoint.time - currentRoutePoint.time;
-		double alphaStep = 1.0 / timeDelta;
-		double alpha = 0.0;
-		int stepCount = (int)timeDelta;
-
-		for (int k = 0; k <= stepCount; ++k)
-		{
-			alignedRoutePoint.time = alignedTime;
-			alignedRoutePoint.position.setX((1.0 - alpha) * currentRoutePoint.position.x() + alpha * nextRoutePoint.position.x());
-			alignedRoutePoint.position.setY((1.0 - alpha) * currentRoutePoint.position.y() + alpha * nextRoutePoint.position.y());
-			alignedRoutePoint.elevation = (1.0 - alpha) * currentRoutePoint.elevation + alpha * nextRoutePoint.elevation;
-			alignedRoutePoint.heartRate = (1.0 - alpha) * currentRoutePoint.heartRate + alpha * nextRoutePoint.heartRate;
-			alignedRoutePoint.pace = (1.0 - alpha) * currentRoutePoint.pace + alpha * nextRoutePoint.pace;
-			alignedRoutePoint.orientation = (1.0 - alpha) * currentRoutePoint.orientation + alpha * nextRoutePoint.orientation;
-
-			alpha += alphaStep;
-
-			if (k < stepCount)
-			{
-				route.alignedRoutePoints.push_back(alignedRoutePoint);
-				alignedTime += 1.0;
-			}
-		}
-
-		currentRoutePoint = alignedRoutePoint;
-		currentRoutePoint.dateTime = nextRoutePoint.dateTime;
-		currentRoutePoint.coordinate = nextRoutePoint.coordinate;
-	}
-
-	route.alignedRoutePoints.push_back(alignedRoutePoint);
-}
-
-void RouteManager::calculateRoutePointColors(Route& route)
-{
-	for (RoutePoint& rp : route.routePoints)
-		rp.color = interpolateFromGreenToRed(route.highPace, route.lowPace, rp.pace);
-
-	for (RoutePoint& rp : route.alignedRoutePoints)
-		rp.color = interpolateFromGreenToRed(route.highPace, route.lowPace, rp.pace);
-}
-
-void RouteManager::calculateRoutePath(Route& route)
-{
-	if (route.routePoints.size() < 2)
-		return;
-
-	route.routePath = QPainterPath();
-
-	for (size_t i = 0; i < route.routePoints.size(); ++i)
-	{
-		RoutePoint& rp = route.routePoints.at(i);
-
-		if (i == 0)
-			route.routePath.moveTo(rp.position.x(), rp.position.y());
-		else
-			route.routePath.lineTo(rp.position.x(), rp.position.y());
-	}
-}
-
-void RouteManager::calculateTailPath(Route& route, double currentTime)
-{
-	double offsetTime = currentTime + route.runnerTimeOffset;
-	double startTime = offsetTime - route.tailLength;
-	double endTime = offsetTime;
-
-	int startIndex = (int)floor(startTime);
-	int endIndex = (int)floor(endTime);
-	int indexMax = (int)route.alignedRoutePoints.size() - 1;
-
-	startIndex = std::max(0, std::min(startIndex, indexMax));
-	endIndex = std::max(0, std::min(endIndex, indexMax));
-
-	route.tailPath = QPainterPath();
-
-	if (startIndex == endIndex)
-		return;
-
-	RoutePoint startRoutePoint = getInterpolatedRoutePoint(route, startTime);
-	RoutePoint endRoutePoint = getInterpolatedRoutePoint(route, endTime);
-
-	route.tailPath.moveTo(startRoutePoint.position.x(), startRoutePoint.position.y());
-
-	for (int i = startIndex + 1; i < endIndex; ++i)
-	{
-		RoutePoint& rp = route.alignedRoutePoints.at(i);
-		route.tailPath.lineTo(rp.position.x(), rp.position.y());
-	}
-
-	route.tailPath.lineTo(endRoutePoint.position.x(), endRoutePoint.position.y());
-}
-
-void RouteManager::calculateControlPositions(Route& route)
-{
-	route.controlPositions.clear();
-
-	for (const Split& split : route.runnerInfo.splits)
-	{
-		RoutePoint rp = getInterpolatedRoutePoint(route, split.absoluteTime + route.controlTimeOffset);
-		route.controlPositions.push_back(rp.position);
-	}
-}
-
-void RouteManager::calculateSplitTransformations(Route& route)
-{
-	if (route.runnerInfo.splits.empty() || route.alignedRoutePoints.empty())
-		return;
-
-	route.splitTransformations.clear();
-
-	// take two consecutive controls and then figure out the transformation needed
-	// to make the line from start to stop control vertical, centered and zoomed appropriately
-	for (int i = 0; i < (int)route.runnerInfo.splits.size() - 1; ++i)
-	{
-		Split split1 = route.runnerInfo.splits.at(i);
-		Split split2 = route.runnerInfo.splits.at(i + 1);
-
-		int startIndex = (int)round(split1.absoluteTime + route.controlTimeOffset);
-		int stopIndex = (int)round(split2.absoluteTime + route.controlTimeOffset);
-		int indexMax = (int)route.alignedRoutePoints.size() - 1;
-
-		startIndex = std::max(0, std::min(startIndex, indexMax));
-		stopIndex = std::max(0, std::min(stopIndex, indexMax));
-
-		SplitTransformation splitTransformation;
-
-		if (startIndex != stopIndex)
-		{
-			RoutePoint startRoutePoint = route.alignedRoutePoints.at(startIndex);
-			RoutePoint stopRoutePoint = route.alignedRoutePoints.at(stopIndex);
-			QPointF startToStop = stopRoutePoint.position - startRoutePoint.position; // vector pointing from start to stop
-
-			// rotate towards positive y-axis
-			double angle = atan2(-startToStop.y(), startToStop.x()) * (180.0 / M_PI);
-			angle = 90.0 - angle;
-
-			// offset so that left quadrants rotate cw and right quadrants ccw
-			if (angle > 180.0)
-				angle = angle - 360.0;
-
-			QMatrix rotateMatrix;
-			rotateMatrix.rotate(-angle);
-
-			double minX = std::numeric_limits<double>::max();
-			double maxX = -std::numeric_limits<double>::max();
-			double minY = std::numeric_limits<double>::max();
-			double maxY = -std::numeric_limits<double>::max();
-
-			// find the bounding box for the split route
-			for (int j = startIndex; j <= stopIndex; ++j)
-			{
-				// points need to be rotated
-				QPointF position = rotateMatrix.map(route.alignedRoutePoints.at(j).position);
-
-				minX = std::min(minX, position.x());
-				maxX = std::max(maxX, position.x());
-				minY = std::min(minY, position.y());
-				maxY = std::max(maxY, position.y());
-			}
-
-			QPointF startPosition = rotateMatrix.map(startRoutePoint.position); // rotated starting position
-			QPointF middlePoint = (startRoutePoint.position + stopRoutePoint.position) / 2.0; // doesn't need to be rotated
-
-			// split width is taken from the maximum deviation from center line to either left or right side
-			double splitWidthLeft = abs(minX - startPosition.x()) * 2.0 + 2.0 * leftRightMargin;
-			double splitWidthRight = abs(maxX - startPosition.x()) * 2.0 + 2.0 * leftRightMargin;
-			double splitWidth = std::max(splitWidthLeft, splitWidthRight);
-
-			// split height is the maximum vertical delta
-			double splitHeight = maxY - minY + 2.0 * topBottomMargin;
-
-			double scaleX = (windowWidth * renderer->getMapPanel().relativeWidth) / splitWidth;
-			double scaleY = windowHeight / splitHeight;
-			double finalScale = std::min(scaleX, scaleY);
-			finalScale = std::min(finalScale, maximumAutomaticZoom);
-
-			splitTransformation.x = -middlePoint.x();
-			splitTransformation.y = middlePoint.y();
-			splitTransformation.angle = angle;
-			splitTransformation.scale = finalScale;
-		}
-
-		route.splitTransformations.push_back(splitTransformation);
-	}
-
-	instantSplitTransitionRequested = true;
-}
-
-void RouteManager::calculateCurrentRunnerPosition(Route& route, double currentTime)
-{
-	RoutePoint rp = getInterpolatedRoutePoint(route, currentTime + route.runnerTimeOffset);
-	route.runnerPosition = rp.position;
-}
-
-void RouteManager::calculateCurrentSplitTransformation(Route& route, double currentTime, double frameTime)
-{
-	if (viewMode == ViewMode::FixedSplit)
-	{
-		int index = -1;
-
-		if (findCurrentSplitTransformationIndex(route, currentTime, index))
-		{
-			if (instantSplitTransitionRequested)
-			{
-				currentSt = route.splitTransformations.at(index);
-				currentSplitTransformationIndex = index;
-				instantSplitTransitionRequested = false;
-				smoothSplitTransitionInProgress = false;
-			}
-			else if (index != currentSplitTransformationIndex)
-			{
-				if (useSmoothSplitTransition)
-				{
-					previousSt = currentSt;
-					nextSt = route.splitTransformations.at(index);
-					smoothSplitTransitionAlpha = 0.0;
-					smoothSplitTransitionInProgress = true;
-
-					double angleDelta = nextSt.angle - previousSt.angle;
-					double absoluteAngleDelta = abs(angleDelta);
-					double finalAngleDelta = angleDelta;
-
-					// always try to rotate as little as possible
-					if (absoluteAngleDelta > 180.0)
-					{
-						finalAngleDelta = 360.0 - absoluteAngleDelta;
-						finalAngleDelta *= (angleDelta < 0.0) ? 1.0 : -1.0;
-					}
-
-					previousSt.angleDelta = finalAngleDelta;
-				}
-				else
-					currentSt = route.splitTransformations.at(index);
-
-				currentSplitTransformationIndex = index;
-			}
-		}
-
-		if (smoothSplitTransitionInProgress)
-		{
-			if (smoothSplitTransitionAlpha > 1.0)
-			{
-				currentSt = nextSt;
-				smoothSplitTransitionInProgress = false;
-			}
-			else
-			{
-				double alpha = smoothSplitTransitionAlpha;
-				alpha = alpha * alpha * alpha * (alpha * (alpha * 6 - 15) + 10); // smootherstep
-
-				currentSt.x = (1.0 - alpha) * previousSt.x + alpha * nextSt.x;
-				currentSt.y = (1.0 - alpha) * previousSt.y + alpha * nextSt.y;
-				currentSt.angle = previousSt.angle + alpha * previousSt.angleDelta;
-				currentSt.scale = (1.0 - alpha) * previousSt.scale + alpha * nextSt.scale;
-
-				smoothSplitTransitionAlpha += smoothSplitTransitionSpeed * frameTime / 1000.0;
-			}
-		}
-	}
-	else if (viewMode == ViewMode::RunnerCentered || viewMode == ViewMode::RunnerCenteredSplitOriented)
-	{
-		RoutePoint rp = getInterpolatedRoutePoint(route, currentTime + route.runnerTimeOffset);
-
-		double x = -rp.position.x();
-		double y = rp.position.y();
-		double angle = rp.orientation;
-
-		if (viewMode == ViewMode::RunnerCenteredSplitOriented)
-		{
-			int index = -1;
-
-			if (findCurrentSplitTransformationIndex(route, currentTime, index))
-				angle = route.splitTransformations.at(index).angle;
-		}
-
-		x -= sin(angle * M_PI / 180.0) * -runnerVerticalOffset;
-		y -= cos(angle * M_PI / 180.0) * -runnerVerticalOffset;
-		
-		if (instantSplitTransitionRequested)
-		{
-			runnerAverageX.reset(x);
-			runnerAverageY.reset(y);
-			runnerAverageAngle.reset(angle);
-
-			instantSplitTransitionRequested = false;
-		}
-		else
-		{
-			runnerAverageX.addMeasurement(x, frameTime);
-			runnerAverageY.addMeasurement(y, frameTime);
-			runnerAverageAngle.addMeasurement(angle, frameTime);
-		}
-
-		currentSt.x = runnerAverageX.getAverage();
-		currentSt.y = runnerAverageY.getAverage();
-		currentSt.angle = runnerAverageAngle.getAverage();
-	}
-}
-
-bool RouteManager::findCurrentSplitTransformationIndex(Route& route, double currentTime, int& index)
-{
-	for (int i = 0; i < (int)route.runnerInfo.splits.size() - 1; ++i)
-	{
-		double firstSplitOffsetTime = route.runnerInfo.splits.at(i).absoluteTime + route.controlTimeOffset;
-		double secondSplitOffsetTime = route.runnerInfo.splits.at(i + 1).absoluteTime + route.controlTimeOffset;
-		double runnerOffsetTime = currentTime + route.runnerTimeOffset;
-
-		// check if we are inside the time range of two consecutive controls
-		if (runnerOffsetTime >= firstSplitOffsetTime && runnerOffsetTime < secondSplitOffsetTime)
-		{
-			if (i >= (int)route.splitTransformations.size())
-				return false;
-
-			index = i;
-			return true;
-		}
-	}
-
-	return false;
-}
-
-RoutePoint RouteManager::getInterpolatedRoutePoint(Route& route, double time)
-{
-	if (route.alignedRoutePoints.empty())
-		return RoutePoint();
-
-	double previousWholeSecond = floor(time);
-	double alpha = time - previousWholeSecond; // the fractional part, i.e milliseconds
-
-	int firstIndex = (int)previousWholeSecond;
-	int secondIndex = firstIndex + 1;
-	int indexMax = (int)route.alignedRoutePoints.size() - 1;
-
-	// limit the indexes inside a valid range
-	firstIndex = std::max(0, std::min(firstIndex, indexMax));
-	secondIndex = std::max(0, std::min(secondIndex, indexMax));
-
-	if (firstIndex == secondIndex)
-		return route.alignedRoutePoints.at(firstIndex);
-	else
-	{
-		RoutePoint firstRp = route.alignedRoutePoints.at(firstIndex);
-		RoutePoint secondRp = route.alignedRoutePoints.at(secondIndex);
-		RoutePoint interpolatedRp = firstRp;
-
-		interpolatedRp.time = time;
-		interpolatedRp.position = (1.0 - alpha) * firstRp.position + alpha * secondRp.position;
-		interpolatedRp.elevation = (1.0 - alpha) * firstRp.elevation + alpha * secondRp.elevation;
-		interpolatedRp.heartRate = (1.0 - alpha) * firstRp.heartRate + alpha * secondRp.heartRate;
-		interpolatedRp.pace = (1.0 - alpha) * firstRp.pace + alpha * secondRp.pace;
-		interpolatedRp.orientation = (1.0 - alpha) * firstRp.orientation + alpha * secondRp.orientation;
-		interpolatedRp.color = interpolateFromGreenToRed(route.highPace, route.lowPace, interpolatedRp.pace);
-
-		return interpolatedRp;
-	}
-}
-
-QColor RouteManager::interpolateFromGreenToRed(double greenValue, double redValue, double value)
-{
-	double alpha = (value - greenValue) / (redValue - greenValue);
-	alpha = std::max(0.0, std::min(alpha, 1.0));
-
-	double r = (alpha > 0.5 ? 1.0 : 2.0 * alpha);
-	double g = (alpha > 0.5 ? 1.0 - 2.0 * (alpha - 0.5) : 1.0);
-	double b = 0.0;
-
-	return QColor::fromRgbF(r, g, b);
-}
-
-void RouteManager::requestFullUpdate()
-{
-	fullUpdateRequested = true;
-}
-
-void RouteManager::requestInstantTransition()
-{
-	instantSplitTransitionRequested = true;
-}
-
-void RouteManager::windowResized(double newWidth, double newHeight)
-{
-	windowWidth = newWidth;
-	windowHeight = newHeight;
-
-	fullUpdateRequested = true;
-}
-
-double RouteManager::getX() const
-{
-	return currentSt.x;
-}
-
-double RouteManager::getY() const
-{
-	return currentSt.y;
-}
-
-double RouteManager::getScale() const
-{
-	return currentSt.scale;
-}
-
-double RouteManager::getAngle() const
-{
-	return currentSt.angle;
-}
-
-ViewMode RouteManager::getViewMode() const
-{
-	return viewMode;
-}
-
-void RouteManager::setViewMode(ViewMode value)
-{
-	viewMode = value;
-	instantSplitTransitionRequested = true;
-}
-
-Route& RouteManager::getDefaultRoute()
-{
-	return routes.at(0);
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+
+#include "RouteManager.h"
+#include "QuickRouteReader.h"
+#include "Renderer.h"
+#include "Settings.h"
+
+using namespace OrientView;
+
+namespace
+{
+	void reserveTrackSamples(RouteTrack& track, int sampleCount)
+	{
+		track.x.reserve(sampleCount);
+		track.y.reserve(sampleCount);
+		track.elevation.reserve(sampleCount);
+		track.heartRate.reserve(sampleCount);
+		track.pace.reserve(sampleCount);
+		track.orientation.reserve(sampleCount);
+	}
+
+	void appendTrackSample(RouteTrack& track, const RoutePoint& rp1, const RoutePoint& rp2, double alpha)
+	{
+		track.x.push_back((1.0 - alpha) * rp1.position.x() + alpha * rp2.position.x());
+		track.y.push_back((1.0 - alpha) * rp1.position.y() + alpha * rp2.position.y());
+		track.elevation.push_back((float)((1.0 - alpha) * rp1.elevation + alpha * rp2.elevation));
+		track.heartRate.push_back((float)((1.0 - alpha) * rp1.heartRate + alpha * rp2.heartRate));
+		track.pace.push_back((float)((1.0 - alpha) * rp1.pace + alpha * rp2.pace));
+		track.orientation.push_back((float)((1.0 - alpha) * rp1.orientation + alpha * rp2.orientation));
+	}
+}
+
+bool RouteManager::initialize(QuickRouteReader* quickRouteReader, SplitsManager* splitsManager, Renderer* renderer, Settings* settings)
+{
+	this->renderer = renderer;
+
+	viewMode = settings->routeManager.viewMode;
+	useSmoothSplitTransition = settings->routeManager.useSmoothSplitTransition;
+	smoothSplitTransitionSpeed = settings->routeManager.smoothSplitTransitionSpeed;
+	topBottomMargin = settings->routeManager.topBottomMargin;
+	leftRightMargin = settings->routeManager.leftRightMargin;
+	maximumAutomaticZoom = settings->routeManager.maximumAutomaticZoom;
+	runnerAveragingFactor = settings->routeManager.runnerAveragingFactor;
+	runnerVerticalOffset = settings->routeManager.runnerVerticalOffset;
+	windowWidth = settings->window.width;
+	windowHeight = settings->window.height;
+
+	runnerAverageX.setAlpha(runnerAveragingFactor / 1000.0);
+	runnerAverageY.setAlpha(runnerAveragingFactor / 1000.0);
+	runnerAverageAngle.setAlpha(runnerAveragingFactor / 1000.0);
+
+	// the default route is referenced while the other routes are added
+	routes.reserve(1 + quickRouteReader->getRunnerCount());
+	routes.push_back(Route());
+	Route& defaultRoute = routes.at(0);
+
+	defaultRoute.routePoints = quickRouteReader->getRoutePoints();
+	defaultRoute.runnerInfo = splitsManager->getDefaultRunnerInfo();
+	defaultRoute.discreetColor = settings->route.discreetColor;
+	defaultRoute.highlightColor = settings->route.highlightColor;
+	defaultRoute.routeRenderMode = settings->route.routeRenderMode;
+	defaultRoute.routeWidth = settings->route.routeWidth;
+	defaultRoute.tailRenderMode = settings->route.tailRenderMode;
+	defaultRoute.tailWidth = settings->route.tailWidth;
+	defaultRoute.tailLength = settings->route.tailLength;
+	defaultRoute.controlBorderColor = settings->route.controlBorderColor;
+	defaultRoute.controlRadius = settings->route.controlRadius;
+	defaultRoute.controlBorderWidth = settings->route.controlBorderWidth;
+	defaultRoute.showControls = settings->route.showControls;
+	defaultRoute.runnerColor = settings->route.runnerColor;
+	defaultRoute.runnerBorderColor = settings->route.runnerBorderColor;
+	defaultRoute.runnerRadius = settings->route.runnerRadius;
+	defaultRoute.runnerBorderWidth = settings->route.runnerBorderWidth;
+	defaultRoute.runnerScale = settings->route.runnerScale;
+	defaultRoute.showRunner = settings->route.showRunner;
+	defaultRoute.controlTimeOffset = settings->route.controlTimeOffset;
+	defaultRoute.runnerTimeOffset = settings->route.runnerTimeOffset;
+	defaultRoute.sampleRate = std::max(1, settings->route.sampleRate);
+	defaultRoute.userScale = settings->route.scale;
+	defaultRoute.lowPace = settings->route.lowPace;
+	defaultRoute.highPace = settings->route.highPace;
+
+	// the track of the default route can come from the route cache
+	if (!quickRouteReader->getCachedRouteTrack(defaultRoute.track))
+	{
+		calculateRouteTrack(defaultRoute);
+		quickRouteReader->writeRouteCache(defaultRoute.track);
+	}
+
+	// the other runners only show their tail and position, in their own color
+	for (int i = 0; i < quickRouteReader->getRunnerCount(); ++i)
+	{
+		QuickRouteReader* runnerRouteReader = quickRouteReader->getRunnerRouteReader(i);
+		const Settings::Runner& runner = settings->runners.at(i);
+
+		routes.push_back(Route());
+		Route& route = routes.back();
+
+		route.routePoints = runnerRouteReader->getRoutePoints();
+		route.runnerInfo.name = runner.name;
+		route.highlightColor = runner.color;
+		route.highlightColor.setAlpha(defaultRoute.highlightColor.alpha());
+		route.routeRenderMode = RouteRenderMode::None;
+		route.tailWidth = defaultRoute.tailWidth;
+		route.showControls = false;
+		route.runnerColor = runner.color;
+		route.runnerBorderColor = defaultRoute.runnerBorderColor;
+		route.runnerRadius = defaultRoute.runnerRadius;
+		route.runnerBorderWidth = defaultRoute.runnerBorderWidth;
+		route.runnerTimeOffset = runner.timeOffset;
+		route.sampleRate = defaultRoute.sampleRate;
+		route.lowPace = defaultRoute.lowPace;
+		route.highPace = defaultRoute.highPace;
+
+		// with the clock time the runners are where they were at the same moment as the default runner
+		if (settings->route.alignRunnersByClockTime && !route.routePoints.empty() && !defaultRoute.routePoints.empty())
+			route.runnerTimeOffset += route.routePoints.at(0).dateTime.msecsTo(defaultRoute.routePoints.at(0).dateTime) / 1000.0;
+
+		if (!runnerRouteReader->getCachedRouteTrack(route.track))
+		{
+			calculateRouteTrack(route);
+			runnerRouteReader->writeRouteCache(route.track);
+		}
+	}
+
+	std::vector<const RouteTrack*> tracks;
+
+	for (Route& route : routes)
+	{
+		calculateTailVertices(route);
+		calculateRoutePointColors(route);
+		calculateRoutePath(route);
+
+		tracks.push_back(&route.track);
+	}
+
+	routeIndex.initialize(tracks);
+
+	update(0.0, 0.0);
+
+	if (viewMode == ViewMode::FixedSplit && currentSplitTransformationIndex == -1 && defaultRoute.splitTransformations.size() > 0)
+	{
+		currentSt = defaultRoute.splitTransformations.at(0);
+		currentSplitTransformationIndex = 0;
+	}
+
+	return true;
+}
+
+void RouteManager::update(double currentTime, double frameTime)
+{
+	SplitTransformation oldSt = currentSt;
+	Route& defaultRoute = routes.at(0);
+	bool runnerMoved = false;
+
+	// smoothing keeps the view moving for a while even if the time does not change
+	const double epsilon = 0.0001;
+
+	isDirty = fullUpdateRequested || instantSplitTransitionRequested;
+
+	// the split times are only known for the default runner, and the view only follows the default route
+	if (fullUpdateRequested)
+	{
+		calculateControlPositions(defaultRoute);
+		calculateSplitTransformations(defaultRoute);
+
+		fullUpdateRequested = false;
+	}
+
+	for (size_t i = 0; i < routes.size(); ++i)
+	{
+		Route& route = routes[i];
+		double routeTime = currentTime;
+
+		// the other runners share the time base of the default runner, and follow the settings that can be changed while playing
+		if (i > 0)
+		{
+			routeTime += defaultRoute.runnerTimeOffset;
+			route.tailRenderMode = (defaultRoute.tailRenderMode == RouteRenderMode::None) ? RouteRenderMode::None : RouteRenderMode::Highlight;
+			route.tailLength = defaultRoute.tailLength;
+			route.showRunner = defaultRoute.showRunner;
+			route.runnerScale = defaultRoute.runnerScale;
+			route.userScale = defaultRoute.userScale;
+		}
+
+		QPointF oldRunnerPosition = route.runnerPosition;
+
+		calculateCurrentRunnerPosition(route, routeTime);
+		calculateTailPath(route, routeTime);
+
+		if ((route.runnerPosition - oldRunnerPosition).manhattanLength() > epsilon)
+			runnerMoved = true;
+	}
+
+	calculateCurrentSplitTransformation(defaultRoute, currentTime, frameTime);
+
+	if (smoothSplitTransitionInProgress ||
+		std::abs(currentSt.x - oldSt.x) > epsilon ||
+		std::abs(currentSt.y - oldSt.y) > epsilon ||
+		std::abs(currentSt.angle - oldSt.angle) > epsilon ||
+		std::abs(currentSt.scale - oldSt.scale) > epsilon ||
+		runnerMoved)
+	{
+		isDirty = true;
+	}
+}
+
+// Resamples the route points at the sample rate in one pass, the first sample is at the first route point.
+void RouteManager::calculateRouteTrack(Route& route)
+{
+	if (route.routePoints.size() < 2)
+		return;
+
+	route.track = RouteTrack();
+
+	const std::vector<RoutePoint>& routePoints = route.routePoints;
+	int lastIndex = (int)routePoints.size() - 1;
+	double firstTime = routePoints.at(0).time;
+	double duration = routePoints.at(lastIndex).time - firstTime;
+	int sampleCount = (int)floor(duration * route.sampleRate) + 1;
+
+	reserveTrackSamples(route.track, sampleCount);
+
+	int index = 0;
+	int segmentIndex = routePoints.at(0).segmentIndex;
+
+	for (int i = 0; i < sampleCount; ++i)
+	{
+		double sampleTime = firstTime + (double)i / route.sampleRate;
+
+		// the points are in time order, so the point pair only ever moves forward
+		while (index < lastIndex - 1 && routePoints[index + 1].time <= sampleTime)
+			index++;
+
+		const RoutePoint& rp1 = routePoints[index];
+		const RoutePoint& rp2 = routePoints[index + 1];
+
+		double timeDelta = rp2.time - rp1.time;
+		double alpha = (timeDelta > 0.0) ? (sampleTime - rp1.time) / timeDelta : 0.0;
+		alpha = std::max(0.0, std::min(alpha, 1.0));
+
+		// the samples inside a gap stay at the end of the previous segment
+		if (rp1.segmentIndex != rp2.segmentIndex)
+			alpha = 0.0;
+
+		if (rp1.segmentIndex != segmentIndex)
+		{
+			route.track.segmentStartIndices.push_back(i);
+			segmentIndex = rp1.segmentIndex;
+		}
+
+		appendTrackSample(route.track, rp1, rp2, alpha);
+	}
+}
+
+void RouteManager::calculateTailVertices(Route& route)
+{
+	route.tailVertices.clear();
+
+	for (int i = 0; i < route.track.getSize(); ++i)
+		route.tailVertices.push_back(route.track.getPosition(i));
+
+	route.tailFirstIndex = 0;
+	route.tailLastIndex = 0;
+}
+
+void RouteManager::calculateRoutePointColors(Route& route)
+{
+	for (RoutePoint& rp : route.routePoints)
+		rp.color = interpolateFromGreenToRed(route.highPace, route.lowPace, rp.pace);
+}
+
+void RouteManager::calculateRoutePath(Route& route)
+{
+	if (route.routePoints.size() < 2)
+		return;
+
+	route.routePath = QPainterPath();
+
+	for (size_t i = 0; i < route.routePoints.size(); ++i)
+	{
+		RoutePoint& rp = route.routePoints.at(i);
+
+		// each segment is a separate subpath, so that the gaps are not drawn
+		if (i == 0 || rp.segmentIndex != route.routePoints.at(i - 1).segmentIndex)
+			route.routePath.moveTo(rp.position.x(), rp.position.y());
+		else
+			route.routePath.lineTo(rp.position.x(), rp.position.y());
+	}
+}
+
+// The tail is a range of the prebuilt tail vertices, so only the two interpolated endpoints change from frame to frame.
+void RouteManager::calculateTailPath(Route& route, double currentTime)
+{
+	if (route.tailVertices.empty())
+		return;
+
+	// put the track positions back where the previous endpoints were
+	route.tailVertices[route.tailFirstIndex] = route.track.getPosition(route.tailFirstIndex);
+	route.tailVertices[route.tailLastIndex] = route.track.getPosition(route.tailLastIndex);
+
+	double offsetTime = currentTime + route.runnerTimeOffset;
+	double startTime = offsetTime - route.tailLength;
+	double endTime = offsetTime;
+
+	int startIndex = (int)floor(startTime * route.sampleRate);
+	int endIndex = (int)floor(endTime * route.sampleRate);
+	int indexMax = route.track.getSize() - 1;
+
+	startIndex = std::max(0, std::min(startIndex, indexMax));
+	endIndex = std::max(0, std::min(endIndex, indexMax));
+
+	route.tailFirstIndex = startIndex;
+	route.tailLastIndex = startIndex;
+
+	if (startIndex == endIndex)
+		return;
+
+	// the interpolated end lies between the end index and the next vertex, or on the last vertex
+	route.tailLastIndex = std::min(endIndex + 1, indexMax);
+
+	RouteSample startSample = getInterpolatedRouteSample(route, startTime);
+	RouteSample endSample = getInterpolatedRouteSample(route, endTime);
+
+	route.tailVertices[route.tailFirstIndex] = QPointF(startSample.x, startSample.y);
+	route.tailVertices[route.tailLastIndex] = QPointF(endSample.x, endSample.y);
+}
+
+void RouteManager::calculateControlPositions(Route& route)
+{
+	route.controlPositions.clear();
+
+	for (const Split& split : route.runnerInfo.splits)
+	{
+		RouteSample sample = getInterpolatedRouteSample(route, split.absoluteTime + route.controlTimeOffset);
+		route.controlPositions.push_back(QPointF(sample.x, sample.y));
+	}
+}
+
+void RouteManager::calculateSplitTransformations(Route& route)
+{
+	if (route.runnerInfo.splits.empty() || route.track.getSize() == 0)
+		return;
+
+	route.splitTransformations.clear();
+
+	// take two consecutive controls and then figure out the transformation needed
+	// to make the line from start to stop control vertical, centered and zoomed appropriately
+	for (int i = 0; i < (int)route.runnerInfo.splits.size() - 1; ++i)
+	{
+		Split split1 = route.runnerInfo.splits.at(i);
+		Split split2 = route.runnerInfo.splits.at(i + 1);
+
+		int startIndex = (int)round((split1.absoluteTime + route.controlTimeOffset) * route.sampleRate);
+		int stopIndex = (int)round((split2.absoluteTime + route.controlTimeOffset) * route.sampleRate);
+		int indexMax = route.track.getSize() - 1;
+
+		startIndex = std::max(0, std::min(startIndex, indexMax));
+		stopIndex = std::max(0, std::min(stopIndex, indexMax));
+
+		SplitTransformation splitTransformation;
+
+		if (startIndex != stopIndex)
+		{
+			QPointF startRoutePosition = route.track.getPosition(startIndex);
+			QPointF stopRoutePosition = route.track.getPosition(stopIndex);
+			QPointF startToStop = stopRoutePosition - startRoutePosition; // vector pointing from start to stop
+
+			// rotate towards positive y-axis
+			double angle = atan2(-startToStop.y(), startToStop.x()) * (180.0 / M_PI);
+			angle = 90.0 - angle;
+
+			// offset so that left quadrants rotate cw and right quadrants ccw
+			if (angle > 180.0)
+				angle = angle - 360.0;
+
+			QMatrix rotateMatrix;
+			rotateMatrix.rotate(-angle);
+
+			double minX = std::numeric_limits<double>::max();
+			double maxX = -std::numeric_limits<double>::max();
+			double minY = std::numeric_limits<double>::max();
+			double maxY = -std::numeric_limits<double>::max();
+
+			// find the bounding box for the split route
+			for (int j = startIndex; j <= stopIndex; ++j)
+			{
+				// points need to be rotated
+				QPointF position = rotateMatrix.map(route.track.getPosition(j));
+
+				minX = std::min(minX, position.x());
+				maxX = std::max(maxX, position.x());
+				minY = std::min(minY, position.y());
+				maxY = std::max(maxY, position.y());
+			}
+
+			QPointF startPosition = rotateMatrix.map(startRoutePosition); // rotated starting position
+			QPointF middlePoint = (startRoutePosition + stopRoutePosition) / 2.0; // doesn't need to be rotated
+
+			// split width is taken from the maximum deviation from center line to either left or right side
+			double splitWidthLeft = abs(minX - startPosition.x()) * 2.0 + 2.0 * leftRightMargin;
+			double splitWidthRight = abs(maxX - startPosition.x()) * 2.0 + 2.0 * leftRightMargin;
+			double splitWidth = std::max(splitWidthLeft, splitWidthRight);
+
+			// split height is the maximum vertical delta
+			double splitHeight = maxY - minY + 2.0 * topBottomMargin;
+
+			double scaleX = (windowWidth * renderer->getMapPanel().relativeWidth) / splitWidth;
+			double scaleY = windowHeight / splitHeight;
+			double finalScale = std::min(scaleX, scaleY);
+			finalScale = std::min(finalScale, maximumAutomaticZoom);
+
+			splitTransformation.x = -middlePoint.x();
+			splitTransformation.y = middlePoint.y();
+			splitTransformation.angle = angle;
+			splitTransformation.scale = finalScale;
+		}
+
+		route.splitTransformations.push_back(splitTransformation);
+	}
+
+	instantSplitTransitionRequested = true;
+}
+
+void RouteManager::calculateCurrentRunnerPosition(Route& route, double currentTime)
+{
+	RouteSample sample = getInterpolatedRouteSample(route, currentTime + route.runnerTimeOffset);
+	route.runnerPosition = QPointF(sample.x, sample.y);
+}
+
+void RouteManager::calculateCurrentSplitTransformation(Route& route, double currentTime, double frameTime)
+{
+	if (viewMode == ViewMode::FixedSplit)
+	{
+		int index = -1;
+
+		if (findCurrentSplitTransformationIndex(route, currentTime, index))
+		{
+			if (instantSplitTransitionRequested)
+			{
+				currentSt = route.splitTransformations.at(index);
+				currentSplitTransformationIndex = index;
+				instantSplitTransitionRequested = false;
+				smoothSplitTransitionInProgress = false;
+			}
+			else if (index != currentSplitTransformationIndex)
+			{
+				if (useSmoothSplitTransition)
+				{
+					previousSt = currentSt;
+					nextSt = route.splitTransformations.at(index);
+					smoothSplitTransitionAlpha = 0.0;
+					smoothSplitTransitionInProgress = true;
+
+					double angleDelta = nextSt.angle - previousSt.angle;
+					double absoluteAngleDelta = abs(angleDelta);
+					double finalAngleDelta = angleDelta;
+
+					// always try to rotate as little as possible
+					if (absoluteAngleDelta > 180.0)
+					{
+						finalAngleDelta = 360.0 - absoluteAngleDelta;
+						finalAngleDelta *= (angleDelta < 0.0) ? 1.0 : -1.0;
+					}
+
+					previousSt.angleDelta = finalAngleDelta;
+				}
+				else
+					currentSt = route.splitTransformations.at(index);
+
+				currentSplitTransformationIndex = index;
+			}
+		}
+
+		if (smoothSplitTransitionInProgress)
+		{
+			if (smoothSplitTransitionAlpha > 1.0)
+			{
+				currentSt = nextSt;
+				smoothSplitTransitionInProgress = false;
+			}
+			else
+			{
+				double alpha = smoothSplitTransitionAlpha;
+				alpha = alpha * alpha * alpha * (alpha * (alpha * 6 - 15) + 10); // smootherstep
+
+				currentSt.x = (1.0 - alpha) * previousSt.x + alpha * nextSt.x;
+				currentSt.y = (1.0 - alpha) * previousSt.y + alpha * nextSt.y;
+				currentSt.angle = previousSt.angle + alpha * previousSt.angleDelta;
+				currentSt.scale = (1.0 - alpha) * previousSt.scale + alpha * nextSt.scale;
+
+				smoothSplitTransitionAlpha += smoothSplitTransitionSpeed * frameTime / 1000.0;
+			}
+		}
+	}
+	else if (viewMode == ViewMode::RunnerCentered || viewMode == ViewMode::RunnerCenteredSplitOriented)
+	{
+		RouteSample sample = getInterpolatedRouteSample(route, currentTime + route.runnerTimeOffset);
+
+		double x = -sample.x;
+		double y = sample.y;
+		double angle = sample.orientation;
+
+		if (viewMode == ViewMode::RunnerCenteredSplitOriented)
+		{
+			int index = -1;
+
+			if (findCurrentSplitTransformationIndex(route, currentTime, index))
+				angle = route.splitTransformations.at(index).angle;
+		}
+
+		x -= sin(angle * M_PI / 180.0) * -runnerVerticalOffset;
+		y -= cos(angle * M_PI / 180.0) * -runnerVerticalOffset;
+		
+		if (instantSplitTransitionRequested)
+		{
+			runnerAverageX.reset(x);
+			runnerAverageY.reset(y);
+			runnerAverageAngle.reset(angle);
+
+			instantSplitTransitionRequested = false;
+		}
+		else
+		{
+			runnerAverageX.addMeasurement(x, frameTime);
+			runnerAverageY.addMeasurement(y, frameTime);
+			runnerAverageAngle.addMeasurement(angle, frameTime);
+		}
+
+		currentSt.x = runnerAverageX.getAverage();
+		currentSt.y = runnerAverageY.getAverage();
+		currentSt.angle = runnerAverageAngle.getAverage();
+	}
+}
+
+// The split is searched starting from the one found on the previous call, so the cost per frame does not grow with the amount of splits.
+bool RouteManager::findCurrentSplitTransformationIndex(Route& route, double currentTime, int& index)
+{
+	const std::vector<Split>& splits = route.runnerInfo.splits;
+	int lastIndex = (int)splits.size() - 2; // the last split that starts a leg
+	double runnerOffsetTime = currentTime + route.runnerTimeOffset;
+
+	if (lastIndex < 0)
+		return false;
+
+	auto splitOffsetTime = [&route, &splits](int i) { return splits.at(i).absoluteTime + route.controlTimeOffset; };
+
+	// check if we are inside the time range of the controls at all
+	if (runnerOffsetTime < splitOffsetTime(0) || runnerOffsetTime >= splitOffsetTime(lastIndex + 1))
+		return false;
+
+	int i = std::max(0, std::min(route.splitCursor, lastIndex));
+	bool isFound = true;
+
+	// during playback the time moves at most to a neighbouring split between two frames
+	if (runnerOffsetTime >= splitOffsetTime(i + 1))
+	{
+		if (i < lastIndex && runnerOffsetTime < splitOffsetTime(i + 2))
+			i++;
+		else
+			isFound = false;
+	}
+	else if (runnerOffsetTime < splitOffsetTime(i))
+	{
+		if (i > 0 && runnerOffsetTime >= splitOffsetTime(i - 1))
+			i--;
+		else
+			isFound = false;
+	}
+
+	// after a seek, binary search for the last split at or before the time
+	if (!isFound)
+	{
+		auto it = std::upper_bound(splits.begin(), splits.end(), runnerOffsetTime, [&route](double time, const Split& split) { return time < split.absoluteTime + route.controlTimeOffset; });
+		i = std::max(0, std::min((int)(it - splits.begin()) - 1, lastIndex));
+	}
+
+	route.splitCursor = i;
+
+	if (i >= (int)route.splitTransformations.size())
+		return false;
+
+	index = i;
+	return true;
+}
+
+RouteSample RouteManager::getInterpolatedRouteSample(const Route& route, double time)
+{
+	const RouteTrack& track = route.track;
+	RouteSample sample = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	if (track.getSize() == 0)
+		return sample;
+
+	double samplePosition = time * route.sampleRate;
+	double previousSample = floor(samplePosition);
+	double alpha = samplePosition - previousSample; // the fraction between two samples
+
+	int firstIndex = (int)previousSample;
+	int secondIndex = firstIndex + 1;
+	int indexMax = track.getSize() - 1;
+
+	// limit the indexes inside a valid range
+	firstIndex = std::max(0, std::min(firstIndex, indexMax));
+	secondIndex = std::max(0, std::min(secondIndex, indexMax));
+
+	// do not slide over a gap between the samples
+	if (firstIndex == secondIndex || track.isSegmentStart(secondIndex))
+		alpha = 0.0;
+
+	sample.x = (1.0 - alpha) * track.x[firstIndex] + alpha * track.x[secondIndex];
+	sample.y = (1.0 - alpha) * track.y[firstIndex] + alpha * track.y[secondIndex];
+	sample.elevation = (1.0 - alpha) * track.elevation[firstIndex] + alpha * track.elevation[secondIndex];
+	sample.heartRate = (1.0 - alpha) * track.heartRate[firstIndex] + alpha * track.heartRate[secondIndex];
+	sample.pace = (1.0 - alpha) * track.pace[firstIndex] + alpha * track.pace[secondIndex];
+	sample.orientation = (1.0 - alpha) * track.orientation[firstIndex] + alpha * track.orientation[secondIndex];
+
+	return sample;
+}
+
+QColor RouteManager::interpolateFromGreenToRed(double greenValue, double redValue, double value)
+{
+	double alpha = (value - greenValue) / (redValue - greenValue);
+	alpha = std::max(0.0, std::min(alpha, 1.0));
+
+	double r = (alpha > 0.5 ? 1.0 : 2.0 * alpha);
+	double g = (alpha > 0.5 ? 1.0 - 2.0 * (alpha - 0.5) : 1.0);
+	double b = 0.0;
+
+	return QColor::fromRgbF(r, g, b);
+}
+
+void RouteManager::requestFullUpdate()
+{
+	fullUpdateRequested = true;
+	isDirty = true;
+}
+
+void RouteManager::requestInstantTransition()
+{
+	instantSplitTransitionRequested = true;
+}
+
+bool RouteManager::getIsDirty() const
+{
+	return isDirty;
+}
+
+void RouteManager::windowResized(double newWidth, double newHeight)
+{
+	windowWidth = newWidth;
+	windowHeight = newHeight;
+
+	fullUpdateRequested = true;
+}
+
+double RouteManager::getX() const
+{
+	return currentSt.x;
+}
+
+double RouteManager::getY() const
+{
+	return currentSt.y;
+}
+
+double RouteManager::getScale() const
+{
+	return currentSt.scale;
+}
+
+double RouteManager::getAngle() const
+{
+	return currentSt.angle;
+}
+
+ViewMode RouteManager::getViewMode() const
+{
+	return viewMode;
+}
+
+void RouteManager::setViewMode(ViewMode value)
+{
+	viewMode = value;
+	instantSplitTransitionRequested = true;
+	isDirty = true;
+}
+
+Route& RouteManager::getDefaultRoute()
+{
+	return routes.at(0);
+}
+
+std::vector<Route>& RouteManager::getRoutes()
+{
+	return routes;
+}
+
+// Finds the video time when the runner nearest to the map position was there, the reverse of the runner time offsets used in the update.
+bool RouteManager::findTimeAtPosition(const QPointF& position, double maxDistance, double& time) const
+{
+	int trackIndex = 0;
+	int sampleIndex = 0;
+
+	if (!routeIndex.findNearestSample(position, maxDistance, trackIndex, sampleIndex))
+		return false;
+
+	const Route& route = routes.at(trackIndex);
+	time = (double)sampleIndex / route.sampleRate - route.runnerTimeOffset;
+
+	if (trackIndex > 0)
+		time -= routes.at(0).runnerTimeOffset;
+
+	return true;
+}
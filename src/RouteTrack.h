@@ -0,0 +1,39 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <QPointF>
+
+namespace OrientView
+{
+	// Route samples at even intervals of the route sample rate, one array per value, so that the per-frame interpolation only touches the values it needs.
+	struct RouteTrack
+	{
+		std::vector<double> x;
+		std::vector<double> y;
+		std::vector<float> elevation;
+		std::vector<float> heartRate;
+		std::vector<float> pace;
+		std::vector<float> orientation;
+		std::vector<int> segmentStartIndices; // ascending sample indexes after a gap, the route is not drawn to them from the previous sample
+
+		int getSize() const { return (int)x.size(); }
+		QPointF getPosition(int index) const { return QPointF(x[index], y[index]); }
+		bool isSegmentStart(int index) const { return std::binary_search(segmentStartIndices.begin(), segmentStartIndices.end(), index); }
+	};
+
+	// Values interpolated from the route track at an arbitrary time.
+	struct RouteSample
+	{
+		double x;
+		double y;
+		double elevation;
+		double heartRate;
+		double pace;
+		double orientation;
+	};
+}
@@ -0,0 +1,88 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "SegmentFile.h"
+
+using namespace OrientView;
+
+bool SegmentFile::open(const QString& fileName, QIODevice::OpenMode mode)
+{
+	file.setFileName(fileName);
+
+	if (!file.open(mode))
+	{
+		qWarning("Could not open segment file %s", qPrintable(fileName));
+		return false;
+	}
+
+	stream.setDevice(&file);
+
+	return true;
+}
+
+bool SegmentFile::writeFrame(x264_nal_t* nal, int nalCount, int64_t pts, int64_t dts, bool isKeyframe)
+{
+	quint32 size = 0;
+
+	for (int i = 0; i < nalCount; ++i)
+		size += (quint32)nal[i].i_payload;
+
+	// the size goes first, so that the reader can allocate the whole payload before reading the NAL units
+	stream << (qint64)pts << (qint64)dts << isKeyframe << size;
+
+	for (int i = 0; i < nalCount; ++i)
+		stream.writeRawData((const char*)nal[i].p_payload, nal[i].i_payload);
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		qWarning("Could not write to segment file");
+		return false;
+	}
+
+	return true;
+}
+
+// Returns false at the end of the file.
+bool SegmentFile::readFrameHeader(int64_t& pts, int64_t& dts, bool& isKeyframe, uint32_t& payloadSize)
+{
+	if (stream.atEnd())
+		return false;
+
+	qint64 tempPts = 0;
+	qint64 tempDts = 0;
+	quint32 tempPayloadSize = 0;
+
+	stream >> tempPts >> tempDts >> isKeyframe >> tempPayloadSize;
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		qWarning("Could not read from segment file");
+		return false;
+	}
+
+	pts = tempPts;
+	dts = tempDts;
+	payloadSize = tempPayloadSize;
+
+	return true;
+}
+
+// Reads the NAL units of the frame whose header was read last, so that the caller can read them straight to their final place.
+bool SegmentFile::readFramePayload(uint8_t* payload, uint32_t payloadSize)
+{
+	if (stream.readRawData((char*)payload, (int)payloadSize) != (int)payloadSize)
+	{
+		qWarning("Could not read from segment file");
+		return false;
+	}
+
+	return true;
+}
+
+void SegmentFile::close()
+{
+	stream.setDevice(nullptr);
+
+	if (file.isOpen())
+		file.close();
+}
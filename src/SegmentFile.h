@@ -0,0 +1,35 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include <QFile>
+#include <QDataStream>
+
+extern "C"
+{
+#include "x264.h"
+}
+
+namespace OrientView
+{
+	// Temporary storage for the encoded frames of one video segment, muxed into the final MP4 file afterwards.
+	class SegmentFile
+	{
+
+	public:
+
+		bool open(const QString& fileName, QIODevice::OpenMode mode);
+		bool writeFrame(x264_nal_t* nal, int nalCount, int64_t pts, int64_t dts, bool isKeyframe);
+		bool readFrameHeader(int64_t& pts, int64_t& dts, bool& isKeyframe, uint32_t& payloadSize);
+		bool readFramePayload(uint8_t* payload, uint32_t payloadSize);
+		void close();
+
+	private:
+
+		QFile file;
+		QDataStream stream;
+	};
+}
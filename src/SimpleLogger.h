@@ -1,29 +1,29 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QFile>
-
-namespace OrientView
-{
-	class MainWindow;
-
-	// Log all the messages to file and to other possible debug outputs.
-	class SimpleLogger
-	{
-
-	public:
-
-		~SimpleLogger();
-
-		void initialize(const QString& fileName);
-		void setMainWindow(MainWindow* mainWindow);
-		void handleMessage(QtMsgType type, const QMessageLogContext& context, const QString& message);
-
-	private:
-
-		QFile logFile;
-		MainWindow* mainWindow = nullptr;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <QFile>
+
+namespace OrientView
+{
+	class MainWindow;
+
+	// Log all the messages to file and to other possible debug outputs.
+	class SimpleLogger
+	{
+
+	public:
+
+		~SimpleLogger();
+
+		void initialize(const QString& fileName);
+		void setMainWindow(MainWindow* mainWindow);
+		void handleMessage(QtMsgType type, const QMessageLogContext& context, const QString& message);
+
+	private:
+
+		QFile logFile;
+		MainWindow* mainWindow = nullptr;
+	};
+}
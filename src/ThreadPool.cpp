@@ -0,0 +1,111 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "ThreadPool.h"
+
+using namespace OrientView;
+
+ThreadPool::~ThreadPool()
+{
+	shutdown();
+}
+
+void ThreadPool::initialize(int workerCount)
+{
+	shutdown();
+
+	shouldStop = false;
+
+	for (int i = 0; i < workerCount; ++i)
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+void ThreadPool::shutdown()
+{
+	mutex.lock();
+	shouldStop = true;
+	workAvailableCondition.wakeAll();
+	mutex.unlock();
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	workers.clear();
+}
+
+// Calls the task with indices from zero to taskCount - 1 and returns when all of them have finished. The calling thread takes tasks too.
+void ThreadPool::run(int taskCount, const std::function<void(int)>& task)
+{
+	if (taskCount <= 0)
+		return;
+
+	if (workers.empty())
+	{
+		for (int i = 0; i < taskCount; ++i)
+			task(i);
+
+		return;
+	}
+
+	mutex.lock();
+
+	currentTask = &task;
+	this->taskCount = taskCount;
+	nextTaskIndex = 0;
+	finishedTaskCount = 0;
+
+	workAvailableCondition.wakeAll();
+
+	while (nextTaskIndex < this->taskCount)
+	{
+		int taskIndex = nextTaskIndex++;
+
+		mutex.unlock();
+		task(taskIndex);
+		mutex.lock();
+
+		finishedTaskCount++;
+	}
+
+	while (finishedTaskCount < this->taskCount)
+		workFinishedCondition.wait(&mutex);
+
+	currentTask = nullptr;
+	this->taskCount = 0;
+	nextTaskIndex = 0;
+	finishedTaskCount = 0;
+
+	mutex.unlock();
+}
+
+// The calling thread of run() is included.
+int ThreadPool::getThreadCount() const
+{
+	return (int)workers.size() + 1;
+}
+
+void ThreadPool::workerLoop()
+{
+	mutex.lock();
+
+	while (true)
+	{
+		while (!shouldStop && nextTaskIndex >= taskCount)
+			workAvailableCondition.wait(&mutex);
+
+		if (shouldStop)
+			break;
+
+		int taskIndex = nextTaskIndex++;
+		const std::function<void(int)>* task = currentTask;
+
+		mutex.unlock();
+		(*task)(taskIndex);
+		mutex.lock();
+
+		if (++finishedTaskCount == taskCount)
+			workFinishedCondition.wakeAll();
+	}
+
+	mutex.unlock();
+}
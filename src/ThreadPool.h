@@ -0,0 +1,45 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace OrientView
+{
+	// Fixed set of worker threads that are started once and reused for every batch of work.
+	class ThreadPool
+	{
+
+	public:
+
+		~ThreadPool();
+
+		void initialize(int workerCount);
+		void shutdown();
+
+		void run(int taskCount, const std::function<void(int)>& task);
+		int getThreadCount() const;
+
+	private:
+
+		void workerLoop();
+
+		std::vector<std::thread> workers;
+
+		QMutex mutex;
+		QWaitCondition workAvailableCondition;
+		QWaitCondition workFinishedCondition;
+
+		const std::function<void(int)>* currentTask = nullptr;
+		int taskCount = 0;
+		int nextTaskIndex = 0;
+		int finishedTaskCount = 0;
+		bool shouldStop = false;
+	};
+}
@@ -1,68 +1,146 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include "VideoDecoderThread.h"
-#include "VideoDecoder.h"
-
-using namespace OrientView;
-
-void VideoDecoderThread::initialize(VideoDecoder* videoDecoder)
-{
-	this->videoDecoder = videoDecoder;
-
-	frameReadSemaphore = new QSemaphore();
-	frameAvailableSemaphore = new QSemaphore();
-	decodedFrameData = FrameData();
-	decodedFrameDataGrayscale = FrameData();
-}
-
-VideoDecoderThread::~VideoDecoderThread()
-{
-	if (frameAvailableSemaphore != nullptr)
-	{
-		delete frameAvailableSemaphore;
-		frameAvailableSemaphore = nullptr;
-	}
-
-	if (frameReadSemaphore != nullptr)
-	{
-		delete frameReadSemaphore;
-		frameReadSemaphore = nullptr;
-	}
-}
-
-void VideoDecoderThread::run()
-{
-	frameReadSemaphore->release(1);
-
-	while (!isInterruptionRequested())
-	{
-		while (!frameReadSemaphore->tryAcquire(1, 100) && !isInterruptionRequested()) {}
-
-		if (isInterruptionRequested())
-			break;
-
-		if (videoDecoder->getNextFrame(&decodedFrameData, &decodedFrameDataGrayscale))
-			frameAvailableSemaphore->release(1);
-		else
-			QThread::msleep(100);
-	}
-}
-
-bool VideoDecoderThread::tryGetNextFrame(FrameData& frameData, FrameData& frameDataGrayscale, int timeout)
-{
-	if (frameAvailableSemaphore->tryAcquire(1, timeout))
-	{
-		frameData = decodedFrameData;
-		frameDataGrayscale = decodedFrameDataGrayscale;
-
-		return true;
-	}
-	else
-		return false;
-}
-
-void VideoDecoderThread::signalFrameRead()
-{
-	frameReadSemaphore->release(1);
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "VideoDecoderThread.h"
+#include "VideoDecoder.h"
+
+using namespace OrientView;
+
+// Queue length above one lets the decoder run ahead, but the extra frames would lag behind seeks during playback.
+// With finish at end, the output queue is finished when the video ends, otherwise the thread waits for a seek.
+void VideoDecoderThread::initialize(VideoDecoder* videoDecoder, int queueLength, bool finishAtEnd)
+{
+	this->videoDecoder = videoDecoder;
+	this->finishAtEnd = finishAtEnd;
+
+	decodedFrameQueue = new PipelineSlotQueue<DecodedFrame>();
+	decodedFrameQueue->initialize(queueLength);
+
+	for (DecodedFrame& decodedFrame : decodedFrameQueue->getSlots())
+		videoDecoder->allocateFrameData(&decodedFrame.frameData, &decodedFrame.frameDataGrayscale);
+
+	addQueue(decodedFrameQueue);
+}
+
+VideoDecoderThread::~VideoDecoderThread()
+{
+	if (decodedFrameQueue != nullptr)
+	{
+		for (DecodedFrame& decodedFrame : decodedFrameQueue->getSlots())
+		{
+			delete[] decodedFrame.frameData.data;
+			delete[] decodedFrame.frameDataGrayscale.data;
+		}
+
+		delete decodedFrameQueue;
+		decodedFrameQueue = nullptr;
+	}
+}
+
+// Also wakes up the thread if it is waiting for a seek at the end of the video.
+void VideoDecoderThread::stop()
+{
+	PipelineStage::stop();
+
+	QMutexLocker locker(&seekMutex);
+	seekCondition.wakeAll();
+}
+
+void VideoDecoderThread::run()
+{
+	while (!isInterruptionRequested())
+	{
+		DecodedFrame* decodedFrame = decodedFrameQueue->acquire();
+
+		if (decodedFrame == nullptr)
+			break;
+
+		// a seek cannot happen in the middle of decoding, so the frame is known to be from before or after it
+		seekMutex.lock();
+
+		// keep the same slot until a frame is decoded to it
+		while (!isInterruptionRequested() && !videoDecoder->getNextFrame(&decodedFrame->frameData, &decodedFrame->frameDataGrayscale))
+		{
+			// a failed frame that is not at the end is skipped by the next try
+			if (!videoDecoder->getIsFinished())
+				continue;
+
+			if (finishAtEnd)
+			{
+				seekMutex.unlock();
+				decodedFrameQueue->finish();
+				return;
+			}
+
+			// at the end of the video, sleep until a seek or stop
+			int generation = seekGeneration.loadAcquire();
+
+			while (!isInterruptionRequested() && seekGeneration.loadAcquire() == generation)
+				seekCondition.wait(&seekMutex);
+		}
+
+		decodedFrame->seekGeneration = seekGeneration.loadAcquire();
+		seekMutex.unlock();
+
+		if (isInterruptionRequested())
+			break;
+
+		decodedFrame->frameData.decodeDuration = videoDecoder->getDecodeDuration();
+		decodedFrameQueue->push();
+	}
+}
+
+// The frame data stays valid until signalFrameRead is called. A negative timeout blocks.
+// Frames that were decoded before the latest seek are dropped here, so that the queue slots are still popped and released in order.
+bool VideoDecoderThread::tryGetNextFrame(FrameData& frameData, FrameData& frameDataGrayscale, int timeout)
+{
+	DecodedFrame* decodedFrame = nullptr;
+
+	while (true)
+	{
+		decodedFrame = decodedFrameQueue->tryPop(timeout);
+
+		if (decodedFrame == nullptr)
+			return false;
+
+		if (decodedFrame->seekGeneration == seekGeneration.loadAcquire())
+			break;
+
+		decodedFrameQueue->release();
+	}
+
+	frameData = decodedFrame->frameData;
+	frameDataGrayscale = decodedFrame->frameDataGrayscale;
+
+	return true;
+}
+
+void VideoDecoderThread::signalFrameRead()
+{
+	decodedFrameQueue->release();
+}
+
+// Seeks relative to the last decoded frame. The frames already in the output queue will not be returned anymore.
+void VideoDecoderThread::seekRelative(double seconds)
+{
+	QMutexLocker locker(&seekMutex);
+
+	videoDecoder->seekRelative(seconds);
+	seekGeneration.fetchAndAddRelease(1);
+	seekCondition.wakeAll();
+}
+
+// Seeks to the given video time in seconds.
+void VideoDecoderThread::seekToTime(double time)
+{
+	QMutexLocker locker(&seekMutex);
+
+	videoDecoder->seekRelative(time - videoDecoder->getCurrentTime());
+	seekGeneration.fetchAndAddRelease(1);
+	seekCondition.wakeAll();
+}
+
+PipelineSlotQueue<DecodedFrame>* VideoDecoderThread::getOutputQueue()
+{
+	return decodedFrameQueue;
+}
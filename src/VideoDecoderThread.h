@@ -1,42 +1,60 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QThread>
-#include <QSemaphore>
-
-#include "FrameData.h"
-
-namespace OrientView
-{
-	class VideoDecoder;
-
-	// Run video decoder on a thread.
-	class VideoDecoderThread : public QThread
-	{
-		Q_OBJECT
-
-	public:
-
-		void initialize(VideoDecoder* videoDecoder);
-		~VideoDecoderThread();
-
-		bool tryGetNextFrame(FrameData& frameData, FrameData& frameDataGrayscale, int timeout);
-		void signalFrameRead();
-
-	protected:
-
-		void run();
-
-	private:
-
-		VideoDecoder* videoDecoder = nullptr;
-
-		QSemaphore* frameReadSemaphore = nullptr;
-		QSemaphore* frameAvailableSemaphore = nullptr;
-
-		FrameData decodedFrameData;
-		FrameData decodedFrameDataGrayscale;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+
+#include "PipelineStage.h"
+#include "PipelineQueue.h"
+#include "FrameData.h"
+
+namespace OrientView
+{
+	class VideoDecoder;
+
+	// Frame data of one decoded frame in the decoder output queue.
+	struct DecodedFrame
+	{
+		FrameData frameData;
+		FrameData frameDataGrayscale;
+		int seekGeneration = 0; // the number of seeks done before the frame was decoded
+	};
+
+	// Run video decoder on a thread.
+	class VideoDecoderThread : public PipelineStage
+	{
+		Q_OBJECT
+
+	public:
+
+		void initialize(VideoDecoder* videoDecoder, int queueLength = 1, bool finishAtEnd = false);
+		~VideoDecoderThread();
+
+		void stop();
+
+		bool tryGetNextFrame(FrameData& frameData, FrameData& frameDataGrayscale, int timeout);
+		void signalFrameRead();
+
+		void seekRelative(double seconds);
+		void seekToTime(double time);
+
+		PipelineSlotQueue<DecodedFrame>* getOutputQueue();
+
+	protected:
+
+		void run();
+
+	private:
+
+		VideoDecoder* videoDecoder = nullptr;
+		PipelineSlotQueue<DecodedFrame>* decodedFrameQueue = nullptr;
+		bool finishAtEnd = false;
+
+		QMutex seekMutex;
+		QWaitCondition seekCondition;
+		QAtomicInt seekGeneration;
+	};
+}
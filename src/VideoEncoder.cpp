@@ -1,163 +1,401 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include "VideoEncoder.h"
-#include "VideoDecoder.h"
-#include "Settings.h"
-#include "FrameData.h"
-#include "Mp4File.h"
-
-using namespace OrientView;
-
-bool VideoEncoder::initialize(VideoDecoder* videoDecoder, Settings* settings)
-{
-	qDebug("Initializing video encoder (%s)", qPrintable(settings->encoder.outputVideoFilePath));
-
-	x264_param_t param;
-
-	if (x264_param_default_preset(&param, qPrintable(settings->encoder.preset), "zerolatency") < 0)
-	{
-		qWarning("Could not apply presets");
-		return false;
-	}
-
-	param.i_width = settings->window.width;
-	param.i_height = settings->window.height;
-	param.i_fps_num = videoDecoder->getFrameRateNum();
-	param.i_fps_den = videoDecoder->getFrameRateDen();
-	param.i_timebase_num = param.i_fps_den;
-	param.i_timebase_den = param.i_fps_num;
-	param.i_csp = X264_CSP_I420;
-	param.rc.i_rc_method = X264_RC_CRF;
-	param.rc.f_rf_constant = settings->encoder.constantRateFactor;
-	param.i_log_level = X264_LOG_NONE;
-
-	x264_param_apply_fastfirstpass(&param);
-
-	if (x264_param_apply_profile(&param, qPrintable(settings->encoder.profile)) < 0)
-	{
-		qWarning("Could not apply profile");
-		return false;
-	}
-
-	// these need to set to zero for MP4 files
-	param.b_annexb = 0;
-	param.b_repeat_headers = 0;
-
-	encoder = x264_encoder_open(&param);
-
-	if (!encoder)
-	{
-		qWarning("Could not open encoder");
-		return false;
-	}
-
-	x264_encoder_parameters(encoder, &param);
-
-	convertedPicture = new x264_picture_t();
-
-	if (x264_picture_alloc(convertedPicture, X264_CSP_I420, settings->window.width, settings->window.height) < 0)
-	{
-		qWarning("Could not allocate encoder picture");
-		return false;
-	}
-
-	swsContext = sws_getContext(settings->window.width, settings->window.height, PIX_FMT_RGBA, settings->window.width, settings->window.height, PIX_FMT_YUV420P, SWS_BILINEAR, nullptr, nullptr, nullptr);
-
-	if (!swsContext)
-	{
-		qWarning("Could not get sws context");
-		return false;
-	}
-
-	mp4File = new Mp4File();
-
-	if (!mp4File->open(settings->encoder.outputVideoFilePath))
-		return false;
-
-	if (!mp4File->setParameters(&param))
-		return false;
-
-	x264_nal_t* nal;
-	int nalCount;
-
-	if (x264_encoder_headers(encoder, &nal, &nalCount) < 0)
-	{
-		qWarning("Could not get encoder headers");
-		return false;
-	}
-
-	if (!mp4File->writeHeaders(nal))
-		return false;
-
-	return true;
-}
-
-VideoEncoder::~VideoEncoder()
-{
-	if (mp4File != nullptr)
-	{
-		delete mp4File;
-		mp4File = nullptr;
-	}
-
-	if (swsContext != nullptr)
-	{
-		sws_freeContext(swsContext);
-		swsContext = nullptr;
-	}
-
-	if (convertedPicture != nullptr)
-	{
-		x264_picture_clean(convertedPicture);
-		delete convertedPicture;
-		convertedPicture = nullptr;
-	}
-
-	if (encoder != nullptr)
-	{
-		x264_encoder_close(encoder);
-		encoder = nullptr;
-	}
-}
-
-void VideoEncoder::readFrameData(const FrameData& frameData)
-{
-	encodeDurationTimer.restart();
-
-	sws_scale(swsContext, &frameData.data, (int*)(&frameData.rowLength), 0, frameData.height, convertedPicture->img.plane, convertedPicture->img.i_stride);
-}
-
-int VideoEncoder::encodeFrame()
-{
-	x264_picture_t encodedPicture;
-	x264_nal_t* nal;
-	int nalCount;
-
-	convertedPicture->i_pts = frameNumber++;
-
-	int frameSize = x264_encoder_encode(encoder, &nal, &nalCount, convertedPicture, &encodedPicture);
-
-	if (frameSize > 0)
-		mp4File->writeFrame(nal[0].p_payload, (size_t)frameSize, &encodedPicture);
-	else
-		qWarning("Could not encode frame");
-
-	QMutexLocker locker(&encoderMutex);
-
-	encodeDuration = encodeDurationTimer.nsecsElapsed() / 1000000.0;
-
-	return frameSize;
-}
-
-void VideoEncoder::close()
-{
-	mp4File->close(frameNumber);
-}
-
-double VideoEncoder::getEncodeDuration()
-{
-	QMutexLocker locker(&encoderMutex);
-
-	return encodeDuration;
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include <algorithm>
+#include <cstring>
+
+#include <QThread>
+
+#include "VideoEncoder.h"
+#include "VideoDecoder.h"
+#include "Settings.h"
+#include "FrameData.h"
+#include "Mp4File.h"
+#include "SegmentFile.h"
+#include "VideoWriterThread.h"
+
+using namespace OrientView;
+
+namespace
+{
+	// thinner slices would not be worth handing to another thread
+	const int minimumSliceHeight = 64;
+
+	// a few seconds of video, enough to ride over the stalls of network and USB drives
+	const int writeQueueLength = 120;
+}
+
+// With a segment file path, the encoded frames are written to a temporary segment file instead of the output file.
+bool VideoEncoder::initialize(VideoDecoder* videoDecoder, Settings* settings, const QString& segmentFilePath)
+{
+	qDebug("Initializing video encoder (%s)", qPrintable(segmentFilePath.isEmpty() ? settings->encoder.outputVideoFilePath : segmentFilePath));
+
+	x264_param_t param;
+
+	// no zerolatency tune, the frame threads and lookahead are what make the encoder scale
+	if (x264_param_default_preset(&param, qPrintable(settings->encoder.preset), nullptr) < 0)
+	{
+		qWarning("Could not apply presets");
+		return false;
+	}
+
+	param.i_width = settings->window.width;
+	param.i_height = settings->window.height;
+	param.i_fps_num = videoDecoder->getFrameRateNum();
+	param.i_fps_den = videoDecoder->getFrameRateDen();
+	param.i_timebase_num = param.i_fps_den;
+	param.i_timebase_den = param.i_fps_num;
+	param.i_csp = X264_CSP_I420;
+	param.rc.i_rc_method = X264_RC_CRF;
+	param.rc.f_rf_constant = settings->encoder.constantRateFactor;
+	param.i_log_level = X264_LOG_NONE;
+
+	if (settings->encoder.threadCount > 0)
+		param.i_threads = settings->encoder.threadCount;
+	else if (!segmentFilePath.isEmpty() && settings->encoder.segmentCount > 1)
+		param.i_threads = std::max(1, QThread::idealThreadCount() / settings->encoder.segmentCount); // the segments are encoded in parallel, so divide the cores between them
+
+	if (settings->encoder.lookahead >= 0)
+		param.rc.i_lookahead = settings->encoder.lookahead;
+
+	if (settings->encoder.bFrames >= 0)
+		param.i_bframe = settings->encoder.bFrames;
+
+	x264_param_apply_fastfirstpass(&param);
+
+	if (x264_param_apply_profile(&param, qPrintable(settings->encoder.profile)) < 0)
+	{
+		qWarning("Could not apply profile");
+		return false;
+	}
+
+	// these need to set to zero for MP4 files
+	param.b_annexb = 0;
+	param.b_repeat_headers = 0;
+
+	encoder = x264_encoder_open(&param);
+
+	if (!encoder)
+	{
+		qWarning("Could not open encoder");
+		return false;
+	}
+
+	x264_encoder_parameters(encoder, &param);
+
+	convertedPicture = new x264_picture_t();
+
+	if (x264_picture_alloc(convertedPicture, X264_CSP_I420, settings->window.width, settings->window.height) < 0)
+	{
+		qWarning("Could not allocate encoder picture");
+		return false;
+	}
+
+	// the color conversion is split into horizontal slices converted in parallel, each slice with its own context
+	// the slices start at even rows, so that the chroma rows are not shared between slices
+	int threadCount = QThread::idealThreadCount();
+
+	if (!segmentFilePath.isEmpty() && settings->encoder.segmentCount > 1)
+		threadCount /= settings->encoder.segmentCount;
+
+	int sliceCount = std::max(1, std::min(threadCount, settings->window.height / minimumSliceHeight));
+	int sliceHeight = (settings->window.height / sliceCount) & ~1;
+
+	for (int i = 0; i < sliceCount; ++i)
+	{
+		int firstRow = i * sliceHeight;
+		int lastRow = (i == sliceCount - 1) ? settings->window.height : firstRow + sliceHeight;
+
+		SwsContext* swsContext = sws_getContext(settings->window.width, lastRow - firstRow, PIX_FMT_RGBA, settings->window.width, lastRow - firstRow, PIX_FMT_YUV420P, SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+		if (!swsContext)
+		{
+			qWarning("Could not get sws context");
+			return false;
+		}
+
+		swsContexts.push_back(swsContext);
+		sliceFirstRows.push_back(firstRow);
+	}
+
+	sliceFirstRows.push_back(settings->window.height);
+
+	// the workers are kept for the whole encode, the calling thread converts one of the slices itself
+	sliceThreadPool.initialize(sliceCount - 1);
+
+	if (!segmentFilePath.isEmpty())
+	{
+		segmentFile = new SegmentFile();
+
+		return segmentFile->open(segmentFilePath, QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+
+	mp4File = new Mp4File();
+
+	if (!mp4File->open(settings->encoder.outputVideoFilePath, settings->encoder.fragmentDuration))
+		return false;
+
+	if (!mp4File->setParameters(&param))
+		return false;
+
+	x264_nal_t* nal;
+	int nalCount;
+
+	if (x264_encoder_headers(encoder, &nal, &nalCount) < 0)
+	{
+		qWarning("Could not get encoder headers");
+		return false;
+	}
+
+	if (!mp4File->writeHeaders(nal))
+		return false;
+
+	videoWriterThread = new VideoWriterThread();
+	videoWriterThread->initialize(mp4File, writeQueueLength);
+	videoWriterThread->start();
+
+	return true;
+}
+
+VideoEncoder::~VideoEncoder()
+{
+	sliceThreadPool.shutdown();
+
+	if (videoWriterThread != nullptr)
+	{
+		videoWriterThread->stop();
+		videoWriterThread->wait();
+		delete videoWriterThread;
+		videoWriterThread = nullptr;
+	}
+
+	if (segmentFile != nullptr)
+	{
+		delete segmentFile;
+		segmentFile = nullptr;
+	}
+
+	if (mp4File != nullptr)
+	{
+		delete mp4File;
+		mp4File = nullptr;
+	}
+
+	for (SwsContext*& swsContext : swsContexts)
+	{
+		if (swsContext != nullptr)
+		{
+			sws_freeContext(swsContext);
+			swsContext = nullptr;
+		}
+	}
+
+	if (convertedPicture != nullptr)
+	{
+		x264_picture_clean(convertedPicture);
+		delete convertedPicture;
+		convertedPicture = nullptr;
+	}
+
+	if (encoder != nullptr)
+	{
+		x264_encoder_close(encoder);
+		encoder = nullptr;
+	}
+}
+
+void VideoEncoder::readFrameData(const FrameData& frameData)
+{
+	encodeDurationTimer.restart();
+
+	sliceThreadPool.run((int)swsContexts.size(), [&](int sliceIndex)
+	{
+		convertSlice(frameData, (size_t)sliceIndex);
+	});
+}
+
+void VideoEncoder::convertSlice(const FrameData& frameData, size_t sliceIndex)
+{
+	int firstRow = sliceFirstRows.at(sliceIndex);
+	int rowCount = sliceFirstRows.at(sliceIndex + 1) - firstRow;
+	int firstChromaRow = firstRow / 2;
+
+	const uint8_t* source[4] = { frameData.data + firstRow * frameData.rowLength, nullptr, nullptr, nullptr };
+	int sourceStride[4] = { (int)frameData.rowLength, 0, 0, 0 };
+
+	uint8_t* destination[4] =
+	{
+		convertedPicture->img.plane[0] + firstRow * convertedPicture->img.i_stride[0],
+		convertedPicture->img.plane[1] + firstChromaRow * convertedPicture->img.i_stride[1],
+		convertedPicture->img.plane[2] + firstChromaRow * convertedPicture->img.i_stride[2],
+		nullptr
+	};
+
+	sws_scale(swsContexts.at(sliceIndex), source, sourceStride, 0, rowCount, destination, convertedPicture->img.i_stride);
+}
+
+// Returns the size of the encoded frame, zero while x264 is still buffering, or a negative value if the frame could not be encoded or written.
+int VideoEncoder::encodeFrame()
+{
+	x264_picture_t encodedPicture;
+	x264_nal_t* nal;
+	int nalCount;
+
+	convertedPicture->i_pts = frameNumber++;
+
+	// the output is an earlier frame or nothing while the lookahead is filling up
+	int frameSize = x264_encoder_encode(encoder, &nal, &nalCount, convertedPicture, &encodedPicture);
+
+	if (frameSize > 0 && !writeFrame(nal, nalCount, &encodedPicture))
+	{
+		qWarning("Could not write frame");
+		frameSize = -1;
+	}
+	else if (frameSize < 0)
+		qWarning("Could not encode frame");
+
+	QMutexLocker locker(&encoderMutex);
+
+	encodeDuration = encodeDurationTimer.nsecsElapsed() / 1000000.0;
+
+	return frameSize;
+}
+
+// Copies the frames of an encoded segment after the frames already in the output file.
+bool VideoEncoder::appendSegment(const QString& segmentFilePath)
+{
+	SegmentFile appendedSegmentFile;
+
+	if (!appendedSegmentFile.open(segmentFilePath, QIODevice::ReadOnly))
+		return false;
+
+	int64_t pts = 0;
+	int64_t dts = 0;
+	bool isKeyframe = false;
+	uint32_t payloadSize = 0;
+	int64_t firstFrameNumber = frameNumber;
+
+	// every segment starts from an IDR frame with zero pts, and the dts stay increasing because every segment has the same B-frame delay
+	while (appendedSegmentFile.readFrameHeader(pts, dts, isKeyframe, payloadSize))
+	{
+		// the payload is read straight into the sample
+		uint8_t* payload = nullptr;
+		lsmash_sample_t* sample = mp4File->createSample(payloadSize, &payload);
+
+		if (sample == nullptr)
+			return false;
+
+		if (!appendedSegmentFile.readFramePayload(payload, payloadSize))
+		{
+			lsmash_delete_sample(sample);
+			return false;
+		}
+
+		if (!videoWriterThread->writeSample(sample, firstFrameNumber + pts, firstFrameNumber + dts, isKeyframe))
+		{
+			qWarning("Could not write frame");
+			return false;
+		}
+
+		frameNumber++;
+	}
+
+	appendedSegmentFile.close();
+
+	return true;
+}
+
+// Returns false if any of the delayed or queued frames could not be encoded or written.
+bool VideoEncoder::close()
+{
+	bool result = true;
+
+	if (encoder != nullptr)
+	{
+		x264_picture_t encodedPicture;
+		x264_nal_t* nal;
+		int nalCount;
+
+		// drain the frames still in the lookahead and frame threads
+		while (x264_encoder_delayed_frames(encoder) > 0)
+		{
+			int frameSize = x264_encoder_encode(encoder, &nal, &nalCount, nullptr, &encodedPicture);
+
+			if (frameSize < 0)
+			{
+				qWarning("Could not encode delayed frame");
+				result = false;
+				break;
+			}
+
+			if (frameSize > 0 && !writeFrame(nal, nalCount, &encodedPicture))
+			{
+				qWarning("Could not write delayed frame");
+				result = false;
+				break;
+			}
+		}
+	}
+
+	if (segmentFile != nullptr)
+		segmentFile->close();
+	else
+	{
+		// the file can only be finished after the writer thread is done with it, the last queued frames can fail too
+		videoWriterThread->finish();
+		mp4File->close(frameNumber);
+
+		if (videoWriterThread->getWriteFailed())
+			result = false;
+	}
+
+	return result;
+}
+
+// The NAL units are copied once, straight into the MP4 sample that is then handed over to the writer thread.
+bool VideoEncoder::writeFrame(x264_nal_t* nal, int nalCount, x264_picture_t* picture)
+{
+	if (segmentFile != nullptr)
+		return segmentFile->writeFrame(nal, nalCount, picture->i_pts, picture->i_dts, picture->b_keyframe != 0);
+
+	size_t payloadSize = 0;
+
+	for (int i = 0; i < nalCount; ++i)
+		payloadSize += (size_t)nal[i].i_payload;
+
+	uint8_t* payload = nullptr;
+	lsmash_sample_t* sample = mp4File->createSample(payloadSize, &payload);
+
+	if (sample == nullptr)
+		return false;
+
+	for (int i = 0; i < nalCount; ++i)
+	{
+		memcpy(payload, nal[i].p_payload, (size_t)nal[i].i_payload);
+		payload += nal[i].i_payload;
+	}
+
+	return videoWriterThread->writeSample(sample, picture->i_pts, picture->i_dts, picture->b_keyframe != 0);
+}
+
+double VideoEncoder::getEncodeDuration()
+{
+	QMutexLocker locker(&encoderMutex);
+
+	return encodeDuration;
+}
+
+int64_t VideoEncoder::getBytesWritten()
+{
+	return (videoWriterThread != nullptr) ? videoWriterThread->getBytesWritten() : 0;
+}
+
+int VideoEncoder::getWriteQueueOccupancy()
+{
+	return (videoWriterThread != nullptr) ? videoWriterThread->getQueueOccupancy() : 0;
+}
+
+int VideoEncoder::getWriteQueueLength()
+{
+	return (videoWriterThread != nullptr) ? videoWriterThread->getQueueLength() : 0;
+}
@@ -1,51 +1,69 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QMutex>
-#include <QElapsedTimer>
-
-extern "C"
-{
-#include <stdint.h>
-#include "x264.h"
-#include "libswscale/swscale.h"
-}
-
-namespace OrientView
-{
-	class VideoDecoder;
-	class Settings;
-	struct FrameData;
-	class Mp4File;
-
-	// Encapsulate the x264 library for encoding video frames.
-	class VideoEncoder
-	{
-
-	public:
-
-		bool initialize(VideoDecoder* videoDecoder, Settings* settings);
-		~VideoEncoder();
-
-		void readFrameData(const FrameData& frameData);
-		int encodeFrame();
-		void close();
-
-		double getEncodeDuration();
-
-	private:
-
-		QMutex encoderMutex;
-
-		x264_t* encoder = nullptr;
-		x264_picture_t* convertedPicture = nullptr;
-		SwsContext* swsContext = nullptr;
-		Mp4File* mp4File = nullptr;
-		int64_t frameNumber = 0;
-
-		QElapsedTimer encodeDurationTimer;
-		double encodeDuration = 0.0;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QString>
+
+#include "ThreadPool.h"
+
+extern "C"
+{
+#include <stdint.h>
+#include "x264.h"
+#include "libswscale/swscale.h"
+}
+
+namespace OrientView
+{
+	class VideoDecoder;
+	class Settings;
+	struct FrameData;
+	class Mp4File;
+	class SegmentFile;
+	class VideoWriterThread;
+
+	// Encapsulate the x264 library for encoding video frames.
+	class VideoEncoder
+	{
+
+	public:
+
+		bool initialize(VideoDecoder* videoDecoder, Settings* settings, const QString& segmentFilePath = QString());
+		~VideoEncoder();
+
+		void readFrameData(const FrameData& frameData);
+		int encodeFrame();
+		bool appendSegment(const QString& segmentFilePath);
+		bool close();
+
+		double getEncodeDuration();
+		int64_t getBytesWritten();
+		int getWriteQueueOccupancy();
+		int getWriteQueueLength();
+
+	private:
+
+		void convertSlice(const FrameData& frameData, size_t sliceIndex);
+		bool writeFrame(x264_nal_t* nal, int nalCount, x264_picture_t* picture);
+
+		QMutex encoderMutex;
+
+		x264_t* encoder = nullptr;
+		x264_picture_t* convertedPicture = nullptr;
+		std::vector<SwsContext*> swsContexts; // one for each slice
+		std::vector<int> sliceFirstRows; // has an extra row at the end
+		ThreadPool sliceThreadPool;
+		Mp4File* mp4File = nullptr;
+		SegmentFile* segmentFile = nullptr;
+		VideoWriterThread* videoWriterThread = nullptr;
+		int64_t frameNumber = 0;
+
+		QElapsedTimer encodeDurationTimer;
+		double encodeDuration = 0.0;
+	};
+}
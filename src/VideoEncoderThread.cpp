@@ -1,55 +1,51 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#include "VideoEncoderThread.h"
-#include "VideoDecoder.h"
-#include "VideoEncoder.h"
-#include "RenderOffScreenThread.h"
-#include "FrameData.h"
-
-using namespace OrientView;
-
-void VideoEncoderThread::initialize(VideoDecoder* videoDecoder, VideoEncoder* videoEncoder, RenderOffScreenThread* renderOffScreenThread)
-{
-	this->videoDecoder = videoDecoder;
-	this->videoEncoder = videoEncoder;
-	this->renderOffScreenThread = renderOffScreenThread;
-}
-
-void VideoEncoderThread::togglePaused()
-{
-	isPaused = !isPaused;
-}
-
-bool VideoEncoderThread::getIsPaused() const
-{
-	return isPaused;
-}
-
-void VideoEncoderThread::run()
-{
-	FrameData renderedFrameData;
-
-	while (!isInterruptionRequested())
-	{
-		if (isPaused)
-		{
-			QThread::msleep(100);
-			continue;
-		}
-
-		if (renderOffScreenThread->tryGetNextFrame(renderedFrameData, 100))
-		{
-			videoEncoder->readFrameData(renderedFrameData);
-			renderOffScreenThread->signalFrameRead();
-			int frameSize = videoEncoder->encodeFrame();
-
-			emit frameProcessed(renderedFrameData.cumulativeNumber, frameSize, videoDecoder->getCurrentTime());
-		}
-		else if (videoDecoder->getIsFinished())
-			break;
-	}
-
-	videoEncoder->close();
-	emit encodingFinished();
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "VideoEncoderThread.h"
+#include "VideoEncoder.h"
+#include "RenderOffScreenThread.h"
+#include "FrameData.h"
+
+using namespace OrientView;
+
+void VideoEncoderThread::initialize(VideoEncoder* videoEncoder, RenderOffScreenThread* renderOffScreenThread)
+{
+	this->videoEncoder = videoEncoder;
+	this->renderOffScreenThread = renderOffScreenThread;
+
+	addQueue(renderOffScreenThread->getOutputQueue());
+}
+
+void VideoEncoderThread::run()
+{
+	FrameData renderedFrameData;
+
+	// the rendered frame queue is finished after the last frame of the video
+	while (waitWhilePaused() && renderOffScreenThread->tryGetNextFrame(renderedFrameData, -1))
+	{
+		videoEncoder->readFrameData(renderedFrameData);
+		renderOffScreenThread->signalFrameRead();
+		int frameSize = videoEncoder->encodeFrame();
+
+		// a frame that could not be written would leave a hole in the output, so the whole encode is stopped
+		if (frameSize < 0)
+		{
+			hasFailed.storeRelease(1);
+			break;
+		}
+
+		// the durations of the earlier stages come with the frame, so they belong to the same frame
+		emit frameProcessed(renderedFrameData.cumulativeNumber, frameSize, renderedFrameData.time, renderedFrameData.decodeDuration, renderedFrameData.stabilizeDuration, renderedFrameData.renderDuration, videoEncoder->getEncodeDuration());
+	}
+
+	if (!videoEncoder->close())
+		hasFailed.storeRelease(1);
+
+	emit encodingFinished();
+}
+
+// Valid after the encodingFinished signal.
+bool VideoEncoderThread::getHasFailed() const
+{
+	return hasFailed.loadAcquire() != 0;
+}
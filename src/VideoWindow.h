@@ -1,49 +1,59 @@
-// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
-// License: GPLv3, see the LICENSE file.
-
-#pragma once
-
-#include <QWindow>
-#include <QOpenGLContext>
-
-namespace OrientView
-{
-	class Settings;
-
-	// Display the live video in a window.
-	class VideoWindow : public QWindow
-	{
-		Q_OBJECT
-
-	public:
-
-		explicit VideoWindow(QWindow* parent = 0);
-		~VideoWindow();
-
-		bool initialize(Settings* settings);
-
-		QOpenGLContext* getContext() const;
-		bool getIsInitialized() const;
-
-		bool keyIsDown(int key);
-		bool keyIsDownOnce(int key);
-
-	signals:
-
-		void closing();
-		void resizing(int newWidth, int newHeight);
-
-	protected:
-
-		bool event(QEvent* event);
-
-	private:
-
-		QOpenGLContext* context = nullptr;
-
-		bool isInitialized = false;
-
-		std::map<int, bool> keyMap;
-		std::map<int, bool> keyMapOnce;
-	};
-}
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <QWindow>
+#include <QOpenGLContext>
+#include <QPointF>
+#include <QMutex>
+
+namespace OrientView
+{
+	class Settings;
+
+	// Display the live video in a window.
+	class VideoWindow : public QWindow
+	{
+		Q_OBJECT
+
+	public:
+
+		explicit VideoWindow(QWindow* parent = 0);
+		~VideoWindow();
+
+		bool initialize(Settings* settings);
+
+		QOpenGLContext* getContext() const;
+		bool getIsInitialized() const;
+
+		bool keyIsDown(int key);
+		bool keyIsDownOnce(int key);
+		bool anyKeyIsDown();
+		bool mouseWasClicked(QPointF& position);
+
+	signals:
+
+		void closing();
+		void resizing(int newWidth, int newHeight);
+		void keyStateChanged();
+
+	protected:
+
+		bool event(QEvent* event);
+
+	private:
+
+		QOpenGLContext* context = nullptr;
+
+		bool isInitialized = false;
+
+		// the input state is written from the GUI thread and read from the render thread
+		QMutex inputMutex;
+		std::map<int, bool> keyMap;
+		std::map<int, bool> keyMapOnce;
+
+		QPointF mouseClickPosition;
+		bool mouseClickPending = false;
+	};
+}
@@ -0,0 +1,118 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#include "VideoWriterThread.h"
+
+using namespace OrientView;
+
+void VideoWriterThread::initialize(Mp4File* mp4File, int queueLength)
+{
+	this->mp4File = mp4File;
+	this->queueLength = queueLength;
+
+	frameQueue.initialize(queueLength);
+	addQueue(&frameQueue);
+}
+
+// The samples that were never written are still owned by the queue.
+VideoWriterThread::~VideoWriterThread()
+{
+	for (EncodedFrame& encodedFrame : frameQueue.getSlots())
+	{
+		if (encodedFrame.sample != nullptr)
+		{
+			lsmash_delete_sample(encodedFrame.sample);
+			encodedFrame.sample = nullptr;
+		}
+	}
+}
+
+void VideoWriterThread::run()
+{
+	EncodedFrame* encodedFrame;
+
+	// the queue is finished after the encoder has been drained
+	while ((encodedFrame = frameQueue.tryPop(-1)) != nullptr)
+	{
+		EncodedFrame frame = *encodedFrame;
+		encodedFrame->sample = nullptr;
+
+		frameQueue.release();
+
+		writerMutex.lock();
+		bool hasFailed = writeFailed;
+		writerMutex.unlock();
+
+		// after a failure the rest of the frames are only dropped, the encoder stops at its next write
+		if (hasFailed)
+		{
+			lsmash_delete_sample(frame.sample);
+			continue;
+		}
+
+		uint32_t sampleSize = frame.sample->length;
+		bool result = mp4File->writeSample(frame.sample, frame.pts, frame.dts, frame.isKeyframe);
+
+		QMutexLocker locker(&writerMutex);
+
+		if (result)
+			bytesWritten += sampleSize;
+		else
+			writeFailed = true;
+	}
+}
+
+// Takes the ownership of the sample, which is created with Mp4File::createSample. Blocks only when the queue is full.
+// Returns false if an earlier frame could not be written.
+bool VideoWriterThread::writeSample(lsmash_sample_t* sample, int64_t pts, int64_t dts, bool isKeyframe)
+{
+	EncodedFrame* encodedFrame = frameQueue.acquire();
+
+	if (encodedFrame == nullptr)
+	{
+		lsmash_delete_sample(sample);
+		return false;
+	}
+
+	encodedFrame->sample = sample;
+	encodedFrame->pts = pts;
+	encodedFrame->dts = dts;
+	encodedFrame->isKeyframe = isKeyframe;
+
+	frameQueue.push();
+
+	QMutexLocker locker(&writerMutex);
+
+	return !writeFailed;
+}
+
+// Called after the last frame. Returns after the queued frames have been written, the file can be closed then.
+void VideoWriterThread::finish()
+{
+	frameQueue.finish();
+	wait();
+}
+
+bool VideoWriterThread::getWriteFailed()
+{
+	QMutexLocker locker(&writerMutex);
+
+	return writeFailed;
+}
+
+int64_t VideoWriterThread::getBytesWritten()
+{
+	QMutexLocker locker(&writerMutex);
+
+	return bytesWritten;
+}
+
+int VideoWriterThread::getQueueOccupancy()
+{
+	return frameQueue.getOccupancy();
+}
+
+int VideoWriterThread::getQueueLength() const
+{
+	return queueLength;
+}
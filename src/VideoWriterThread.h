@@ -0,0 +1,56 @@
+// Copyright © 2014 Mikko Ronkainen <firstname@mikkoronkainen.com>
+// License: GPLv3, see the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+
+#include <QMutex>
+
+#include "PipelineStage.h"
+#include "PipelineQueue.h"
+#include "Mp4File.h"
+
+namespace OrientView
+{
+	// One encoded frame waiting to be muxed. The sample is already in its final form and goes to l-smash as is.
+	struct EncodedFrame
+	{
+		lsmash_sample_t* sample = nullptr;
+		int64_t pts = 0;
+		int64_t dts = 0;
+		bool isKeyframe = false;
+	};
+
+	// Mux the encoded frames into the MP4 file on a thread, so that slow output storage does not stall the encoder.
+	class VideoWriterThread : public PipelineStage
+	{
+
+	public:
+
+		void initialize(Mp4File* mp4File, int queueLength);
+		~VideoWriterThread();
+
+		bool writeSample(lsmash_sample_t* sample, int64_t pts, int64_t dts, bool isKeyframe);
+		void finish();
+
+		bool getWriteFailed();
+		int64_t getBytesWritten();
+		int getQueueOccupancy();
+		int getQueueLength() const;
+
+	protected:
+
+		void run();
+
+	private:
+
+		Mp4File* mp4File = nullptr;
+		PipelineSlotQueue<EncodedFrame> frameQueue;
+		int queueLength = 0;
+
+		QMutex writerMutex;
+		int64_t bytesWritten = 0;
+		bool writeFailed = false;
+	};
+}